@@ -0,0 +1,74 @@
+// Function::step cost with and without live metrics (single- and multi-threaded).
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "acc/function.hpp"
+#include "acc/metrics.hpp"
+
+static std::vector<acc::Input> make_inputs(std::size_t n) {
+  // FOLLOW with a slowly oscillating closing speed, plus an occasional lead dropout
+  std::vector<acc::Input> ins(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    acc::Input& in = ins[i];
+    in.t_s = 0.02 * static_cast<double>(i);
+    in.acc_enable = true;
+    in.ego_speed_mps = 20.0 + static_cast<double>(i % 200) * 0.01;
+    in.lead_valid = (i % 1000) < 900;
+    in.lead_distance_m = 30.0 + static_cast<double>(i % 500) * 0.05;
+    in.lead_rel_speed_mps = -2.0 + static_cast<double>(i % 300) * 0.01;
+  }
+  return ins;
+}
+
+// ns per step for one thread running `steps` steps
+static double run(acc::Metrics* metrics, const std::vector<acc::Input>& ins, std::size_t steps) {
+  acc::Function fn(acc::Config{});
+  fn.attach_metrics(metrics);
+  double sink = 0.0;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < steps; ++i) sink += fn.step(ins[i % ins.size()]).a_cmd_mps2;
+  const auto dt = std::chrono::steady_clock::now() - t0;
+
+  volatile double keep = sink;
+  (void)keep;
+  return std::chrono::duration<double, std::nano>(dt).count() / static_cast<double>(steps);
+}
+
+static double run_threads(acc::Metrics* metrics, const std::vector<acc::Input>& ins,
+                          std::size_t steps, std::size_t threads) {
+  std::vector<double> ns(threads);
+  std::vector<std::thread> pool;
+  for (std::size_t t = 0; t < threads; ++t) {
+    pool.emplace_back([&, t] { ns[t] = run(metrics, ins, steps); });
+  }
+  for (auto& th : pool) th.join();
+  return *std::max_element(ns.begin(), ns.end());
+}
+
+int main(int argc, char** argv) {
+  const std::size_t steps = (argc > 1) ? std::stoul(argv[1]) : 5000000;
+  const std::size_t threads = std::max(2U, std::thread::hardware_concurrency());
+  const auto ins = make_inputs(4096);
+
+  acc::Metrics sampled(64);
+  acc::Metrics every(1);
+
+  run(nullptr, ins, steps / 10);  // warm-up
+
+  std::printf("%-40s %10s\n", "configuration", "ns/step");
+  std::printf("%-40s %10.2f\n", "no metrics", run(nullptr, ins, steps));
+  std::printf("%-40s %10.2f\n", "metrics, latency every 64th step", run(&sampled, ins, steps));
+  std::printf("%-40s %10.2f\n", "metrics, latency every step", run(&every, ins, steps));
+
+  const std::string mt = std::to_string(threads) + " threads, ";
+  std::printf("%-40s %10.2f\n", (mt + "no metrics").c_str(),
+              run_threads(nullptr, ins, steps, threads));
+  std::printf("%-40s %10.2f\n", (mt + "shared metrics (64th)").c_str(),
+              run_threads(&sampled, ins, steps, threads));
+  return 0;
+}
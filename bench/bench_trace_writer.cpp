@@ -0,0 +1,92 @@
+// Trace CSV throughput: the previous operator<< writer against sim::TraceWriter (std::to_chars).
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "sim/trace_csv.hpp"
+
+static std::vector<sim::Sample> make_samples(std::size_t n) {
+  // FOLLOW-like signals with full-precision values, as the closed loop produces them
+  std::vector<sim::Sample> ss(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const double t = 0.02 * static_cast<double>(i);
+    sim::Sample& s = ss[i];
+    s.in.t_s = t;
+    s.in.v_set_mps = 30.0;
+    s.in.lead_valid = (i % 1000) < 900;
+    s.in.lead_rel_speed_mps = -2.0 * std::sin(0.1 * t);
+    s.out.mode = s.in.lead_valid ? acc::Mode::FOLLOW : acc::Mode::CRUISE;
+    s.out.a_cmd_mps2 = 1.5 * std::cos(0.07 * t);
+    s.out.ttc_s = (s.in.lead_rel_speed_mps < 0.0) ? 40.0 / -s.in.lead_rel_speed_mps
+                                                   : std::numeric_limits<double>::infinity();
+    s.out.d_des_m = 3.0 + 1.5 * (25.0 + std::sin(0.05 * t));
+    s.out.distance_error_m = 2.0 * std::sin(0.03 * t);
+    s.out.a_cruise_mps2 = 0.6 * std::cos(0.01 * t);
+    s.out.a_follow_mps2 = -0.3 * std::sin(0.02 * t);
+    s.ego_speed_mps = 25.0 + std::sin(0.05 * t);
+    s.lead_distance_m = 40.0 + 2.0 * std::sin(0.03 * t);
+  }
+  return ss;
+}
+
+// The writer sim_runner used before sim::TraceWriter.
+static void ostream_row(std::ostream& os, const sim::Sample& s) {
+  const auto& in = s.in;
+  const auto& y = s.out;
+  os << in.t_s << "," << static_cast<int>(y.mode) << "," << s.ego_speed_mps << ","
+     << in.v_set_mps << "," << (in.lead_valid ? 1 : 0) << "," << s.lead_distance_m << ","
+     << in.lead_rel_speed_mps << "," << y.a_cmd_mps2 << "," << y.ttc_s << "," << y.d_des_m << ","
+     << y.distance_error_m << "," << y.a_cruise_mps2 << "," << y.a_follow_mps2 << "\n";
+}
+
+template <typename F>
+static void report(const char* name, const std::string& path, std::size_t rows, F&& write) {
+  const auto t0 = std::chrono::steady_clock::now();
+  {
+    std::ofstream f(path);
+    write(f);
+  }
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  const auto bytes = static_cast<double>(std::filesystem::file_size(path));
+  std::printf("%-34s %8.1f ns/row %8.1f MB/s %8.1f B/row\n", name,
+              s * 1e9 / static_cast<double>(rows), bytes / s * 1e-6,
+              bytes / static_cast<double>(rows));
+}
+
+int main(int argc, char** argv) {
+  const std::size_t rows = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+  const std::string path =
+      (argc > 2) ? argv[2] : (std::filesystem::temp_directory_path() / "bench_trace.csv").string();
+  const auto ss = make_samples(rows);
+
+  std::printf("%zu rows -> %s\n", rows, path.c_str());
+  report("operator<< (previous writer)", path, rows, [&](std::ofstream& f) {
+    for (const auto& s : ss) ostream_row(f, s);
+  });
+  report("TraceWriter, precision 6 (default)", path, rows, [&](std::ofstream& f) {
+    sim::TraceWriter w(f);
+    for (const auto& s : ss) w.add(s);
+  });
+  report("TraceWriter, shortest round-trip", path, rows, [&](std::ofstream& f) {
+    sim::TraceWriter w(f, sim::TraceFormat{{}, 0, 1});
+    for (const auto& s : ss) w.add(s);
+  });
+  report("TraceWriter, 4 columns", path, rows, [&](std::ofstream& f) {
+    sim::TraceFormat fmt;
+    fmt.columns = sim::parse_trace_columns("t_s,mode,lead_distance_m,a_cmd_mps2");
+    sim::TraceWriter w(f, fmt);
+    for (const auto& s : ss) w.add(s);
+  });
+  report("TraceWriter, every 10th row", path, rows, [&](std::ofstream& f) {
+    sim::TraceWriter w(f, sim::TraceFormat{{}, 6, 10});
+    for (const auto& s : ss) w.add(s);
+  });
+
+  std::filesystem::remove(path);
+  return 0;
+}
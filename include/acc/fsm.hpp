@@ -16,6 +16,7 @@ class Fsm {
   Mode update(const Config& cfg, const Input& in, double ttc_s, bool plausible);
 
   const FsmState& state() const { return state_; }
+  void restore(const FsmState& s) { state_ = s; }
 
  private:
   FsmState state_{};
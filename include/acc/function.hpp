@@ -1,10 +1,18 @@
 #pragma once
 #include "acc/config.hpp"
 #include "acc/fsm.hpp"
+#include "acc/metrics.hpp"
 #include "acc/types.hpp"
 
 namespace acc {
 
+// Complete internal state of Function (snapshot/restore, e.g. for fast-forwarding the sim).
+struct FunctionState {
+  FsmState fsm{};
+  Output prev_out{};
+  double cruise_i{0.0};
+};
+
 class Function {
  public:
   explicit Function(Config cfg) : cfg_(cfg) {}
@@ -17,11 +25,26 @@ class Function {
 
   Output step(const Input& in);
 
+  const Config& config() const { return cfg_; }
+
+  // Optional live metrics (not owned; nullptr disables). Shared by any number of Functions.
+  void attach_metrics(Metrics* m) { metrics_ = m; }
+
+  FunctionState state() const { return FunctionState{fsm_.state(), prev_out_, cruise_i_}; }
+  void restore(const FunctionState& s) {
+    fsm_.restore(s.fsm);
+    prev_out_ = s.prev_out;
+    cruise_i_ = s.cruise_i;
+  }
+
  private:
+  Output step_impl(const Input& in);
+
   Config cfg_;
   Fsm fsm_;
   Output prev_out_{};
   double cruise_i_{0.0};
+  Metrics* metrics_{nullptr};
 };
 
 }  // namespace acc
\ No newline at end of file
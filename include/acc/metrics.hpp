@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "acc/types.hpp"
+
+namespace acc {
+
+constexpr std::size_t kNumModes = 5;
+
+struct MetricsSnapshot {
+  static constexpr std::size_t kLatencyBuckets = 10;
+  // upper bucket bounds [ns]; the last bucket is +inf
+  static constexpr std::array<std::uint64_t, kLatencyBuckets - 1> kLatencyBoundsNs = {
+      50, 100, 200, 500, 1000, 2000, 5000, 10000, 100000};
+
+  std::uint64_t steps{0};
+  std::array<std::uint64_t, kNumModes> mode_ticks{};  // indexed by Mode
+  std::uint64_t aeb_activations{0};
+  double ttc_min_s{0.0};       // +inf until a finite TTC was seen
+  double jerk_peak_mps3{0.0};  // |da|/Ts, steps into/out of AEB excluded (as in the KPIs)
+
+  // step latency, measured on every latency_sample_every-th step of each thread
+  std::array<std::uint64_t, kLatencyBuckets> latency_buckets{};  // non-cumulative
+  std::uint64_t latency_count{0};
+  std::uint64_t latency_sum_ns{0};
+  std::uint64_t latency_max_ns{0};
+};
+
+class ShardClaims;
+
+// Live controller metrics for farm/soak runs. Each writer thread (Function::step) claims its own
+// cache-line aligned shard on first use and updates it with relaxed atomic load/store only (no
+// locks, no read-modify-write); the shard is returned when the thread exits. Threads beyond
+// kShards - 1 live at once share one overflow shard that uses atomic read-modify-write instead.
+// snapshot() may run at any time from any thread.
+class Metrics {
+ public:
+  static constexpr std::size_t kShards = 64;
+
+  explicit Metrics(std::uint32_t latency_sample_every = 64);
+  ~Metrics();
+
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  // writer side
+  void record_step(Mode mode, bool aeb_entered, double ttc_s, double jerk_mps3);
+  void record_ticks(Mode mode, std::uint64_t n);  // ticks that bypassed step (fast-forward)
+  bool latency_due();                             // true on every N-th call per thread
+  void record_latency_ns(std::uint64_t ns);
+
+  // reader side
+  MetricsSnapshot snapshot() const;
+  std::size_t exclusive_writers() const;  // threads currently holding their own shard
+
+ private:
+  friend class ShardClaims;
+
+  struct alignas(64) Shard {
+    std::atomic<std::uint64_t> steps{0};
+    std::array<std::atomic<std::uint64_t>, kNumModes> mode_ticks{};
+    std::atomic<std::uint64_t> aeb_activations{0};
+    std::atomic<double> ttc_min_s{std::numeric_limits<double>::infinity()};
+    std::atomic<double> jerk_peak_mps3{0.0};
+    std::atomic<std::uint32_t> latency_tick{0};
+    std::array<std::atomic<std::uint64_t>, MetricsSnapshot::kLatencyBuckets> latency_buckets{};
+    std::atomic<std::uint64_t> latency_count{0};
+    std::atomic<std::uint64_t> latency_sum_ns{0};
+    std::atomic<std::uint64_t> latency_max_ns{0};
+  };
+  struct Writer {
+    Shard* shard;
+    bool exclusive;  // sole writer of *shard
+  };
+  Writer local();
+
+  std::uint64_t id_;  // distinguishes registries in the per-thread shard cache
+  std::uint32_t latency_sample_every_;
+  std::size_t next_shard_{0};             // guarded by the registry lock in metrics.cpp
+  std::vector<std::size_t> free_shards_;  // returned by exited threads, same lock
+  std::array<Shard, kShards> shards_{};
+};
+
+}  // namespace acc
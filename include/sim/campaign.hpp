@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "acc/config.hpp"
+#include "sim/closed_loop.hpp"
+#include "sim/kpi.hpp"
+#include "sim/trace_csv.hpp"
+
+namespace sim {
+
+// In-process scenario campaign: load -> simulate -> KPI -> write, one thread per stage
+// (simulation on a worker pool) with bounded queues in between. A slow disk or slow parser
+// only stalls its own stage until the queue in front of it fills up. Traces are written as
+// plain CSV (no compression stage).
+//
+// Traces are formatted by the simulation workers into per-worker arenas and written by one
+// background thread in large writev calls. <out_dir>/index.csv lists every run by
+// (scenario, config hash) with its trace location and KPIs.
+struct CampaignOptions {
+  std::string out_dir{"results/campaign"};
+  RunOptions run{};
+  std::vector<acc::Config> configs{};  // sweep; empty -> one default Config
+  bool pack_traces{false};             // all traces in <out_dir>/traces.pack, no per-run files
+  bool kpi_reports{false};  // also <name>_kpi.txt per run (unless packing); index.csv has the KPIs
+  TraceFormat trace{};                 // columns/precision/decimation of the written traces
+  std::size_t arena_block_bytes{256 * 1024};
+  std::size_t sim_workers{0};       // 0 -> std::thread::hardware_concurrency()
+  std::size_t queue_depth{8};       // items per inter-stage queue
+  std::size_t chunk_samples{4096};  // samples per KPI batch handed downstream
+};
+
+struct CampaignResult {
+  std::string scenario_path;
+  std::uint64_t config_hash{0};
+  std::string trace_path;   // <out_dir>/<scenario stem>[_<config hash>].csv, or the pack
+  std::string report_path;  // <out_dir>/<scenario stem>[_<config hash>]_kpi.txt, else index.csv
+  std::uint64_t trace_offset{0};  // byte range of this run's trace (header included)
+  std::uint64_t trace_bytes{0};
+  Kpis kpis{};
+  std::string error;  // empty on success
+};
+
+// Stable across runs and platforms. Ts_s is left out: every run takes it from its scenario.
+std::uint64_t config_hash(const acc::Config& cfg, const RunOptions& run);
+
+// Results are returned scenario-major in the order of scenario_paths, then configs. The config
+// hash is only appended to file names when more than one config is swept.
+std::vector<CampaignResult> run_campaign(const std::vector<std::string>& scenario_paths,
+                                         const CampaignOptions& opt);
+
+}  // namespace sim
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+#include "acc/config.hpp"
+#include "acc/metrics.hpp"
+#include "acc/types.hpp"
+#include "sim/scenario.hpp"
+
+namespace sim {
+
+struct RunOptions {
+  bool aeb_enable{true};
+
+  // Quiescent CRUISE stretches (lead invalid, scenario inputs constant, loop provably inside
+  // its linear region) bypass Function::step and run the reduced PI loop instead. A stretch is
+  // logged as its first tick plus one summary row (Sample::ticks > 1) holding the exact state
+  // of its last tick.
+  bool fast_forward{false};
+  double ff_max_skip_s{5.0};     // longest stretch per summary row
+  double ff_exact_tail_s{5.0};   // always stepped exactly (steady-state KPI windows)
+
+  acc::Metrics* metrics{nullptr};  // live telemetry, shared across runs/threads (optional)
+};
+
+// One logged tick. Plant signals are taken after the update of this tick.
+struct Sample {
+  acc::Input in;
+  acc::Output out;
+  double ego_speed_mps{0.0};
+  double lead_distance_m{0.0};  // as seen by the sensor (inf while lead_valid=0)
+  double lead_gap_m{0.0};       // physical gap, also tracked through lead_valid dropouts
+  std::size_t ticks{1};         // ticks ending at in.t_s this row stands for (fast-forward)
+};
+
+struct RunStats {
+  std::size_t ticks{0};    // simulated controller ticks
+  std::size_t steps{0};    // ticks actually run through Function::step
+  std::size_t samples{0};  // samples passed to the sink (fewer than ticks with fast-forward)
+};
+
+using SampleSink = std::function<void(const Sample&)>;
+
+// Closed loop of acc::Function and the nominal longitudinal plant over the scenario.
+RunStats run_closed_loop(const Scenario& sc, const acc::Config& cfg, const RunOptions& opt,
+                         const SampleSink& sink);
+
+}  // namespace sim
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "acc/config.hpp"
+#include "sim/scenario.hpp"
+
+namespace sim {
+
+// Parametric lead-vehicle scenario family searched by the falsifier.
+struct LeadCaseParams {
+  double ego_speed_mps{25.0};   // initial ego speed, also used as v_set
+  double lead_speed_mps{25.0};  // initial lead speed
+  double gap_m{40.0};           // gap when the lead becomes visible
+  double cut_in_s{0.0};         // lead visible from this time (< 2 ticks: visible from start)
+  double brake_start_s{2.0};    // lead starts braking
+  double brake_decel_mps2{4.0}; // lead deceleration down to standstill
+  double dropout_start_s{0.0};  // lead_valid=0 window (sensor dropout)
+  double dropout_len_s{0.0};    // (< 2 ticks: no dropout)
+};
+
+// Search envelope; values are clamped into [lo, hi] field by field.
+struct LeadCaseBounds {
+  LeadCaseParams lo{10.0, 0.0, 5.0, 0.0, 0.0, 0.5, 0.0, 0.0};
+  LeadCaseParams hi{35.0, 35.0, 100.0, 4.0, 10.0, 9.0, 15.0, 1.5};
+};
+
+// Builds the scenario rows; event times are snapped to the Ts grid.
+Scenario make_lead_case(const LeadCaseParams& p, double duration_s, double Ts_s);
+
+enum class FalsifyObjective : std::uint8_t {
+  MIN_DISTANCE = 0,   // minimise the physical gap (collision = 0)
+  FALSE_AEB = 1,      // maximise AEB time where ACC alone would have kept >= margin
+};
+
+struct FalsifyOptions {
+  FalsifyObjective objective{FalsifyObjective::MIN_DISTANCE};
+  LeadCaseBounds bounds{};
+  double duration_s{15.0};
+  double Ts_s{0.02};
+  double false_aeb_margin_m{2.0};  // FALSE_AEB: min gap with AEB disabled must stay above this
+
+  // cross-entropy search
+  std::size_t iterations{20};
+  std::size_t population{64};
+  double elite_frac{0.125};
+  double smoothing{0.7};  // weight of the new elite statistics per iteration
+  std::uint64_t seed{1};
+  std::size_t workers{0};  // 0 -> std::thread::hardware_concurrency()
+  std::size_t keep{5};     // worst cases returned
+};
+
+struct FalsifyCase {
+  LeadCaseParams params{};
+  double score{0.0};  // lower = worse for the function
+  double min_gap_m{0.0};
+  double aeb_time_s{0.0};
+  bool feasible{true};  // an ideal a_min brake from first sight avoids collision
+};
+
+// Closed-loop score of one parameter set (deterministic).
+FalsifyCase evaluate_lead_case(const LeadCaseParams& p, const acc::Config& cfg,
+                               const FalsifyOptions& opt);
+
+// Cross-entropy search; returns up to opt.keep feasible cases, worst first. FALSE_AEB only
+// returns runs where AEB fired.
+// Results do not depend on opt.workers.
+std::vector<FalsifyCase> falsify(const acc::Config& cfg, const FalsifyOptions& opt);
+
+}  // namespace sim
@@ -0,0 +1,56 @@
+#pragma once
+#include "acc/config.hpp"
+
+namespace sim {
+
+// Reduced CRUISE PI loop on the nominal plant (v[k+1] = v[k] + a*Ts).
+//
+// With x = [e_v, I] (speed error, integrator) the loop is linear, x[k+1] = A x[k], as long as
+// the jerk limiter, integrator clamp, anti-windup and accel limits stay inactive.
+// stays_linear() proves that for every future tick from the entry state (bound
+// M = sup_k ||A^k||_inf), with |a| and |a[k] - a[k-1]| / Ts kept below half their limits. In
+// that region tick() is exactly what Function::step computes, without FSM, plausibility,
+// TTC and limiter evaluation.
+class CruiseFastForward {
+ public:
+  explicit CruiseFastForward(const acc::Config& cfg);
+
+  // false if the PI gains do not give a contractive loop (skipping is then never allowed)
+  bool available() const { return available_; }
+
+  // Entry test: state after the last exact step (a_prev = its a_cmd).
+  bool stays_linear(double e_v, double cruise_i, double a_prev, double v_set) const;
+
+  // One tick after stays_linear(): updates the integrator and returns a_cmd (same operations and
+  // order as Function::step, so the result is bit-identical).
+  double tick(double e_v, double& cruise_i) const {
+    cruise_i = cruise_i + ki_ * e_v * Ts_;
+    return kp_ * e_v + cruise_i;
+  }
+
+ private:
+  struct Mat2 {
+    double a, b, c, d;  // [[a, b], [c, d]]
+  };
+  static Mat2 mul(const Mat2& x, const Mat2& y);
+  static double norm_inf(const Mat2& m);
+
+  // Upper bound on ||x|| = max(|e_v|, |I|) for every future tick from this state.
+  double state_bound(double e_v, double cruise_i) const;
+
+  double Ts_{0.0};
+  double kp_{0.0};
+  double ki_{0.0};
+
+  Mat2 A_{};
+  double c_e_{0.0};  // a = c_e * e_v + c_i * I
+  double c_i_{1.0};
+  double gain_da_{0.0};  // ||c^T (A - I)||_1, bounds |a[k] - a[k-1]| per unit ||x||
+  double sup_pow_{1.0};  // sup_k ||A^k||_inf
+  double max_da_{0.0};   // allowed |a[k] - a[k-1]| (comfort jerk * Ts, with margin)
+  double max_a_{0.0};    // allowed |a|
+  double max_i_{0.0};    // allowed |I|
+  bool available_{false};
+};
+
+}  // namespace sim
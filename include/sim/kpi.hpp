@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+#include "acc/config.hpp"
+#include "sim/closed_loop.hpp"
+
+namespace sim {
+
+// Same metrics as tools/evaluate_kpis.py, accumulated while the trace streams by.
+struct Kpis {
+  double min_distance_m{0.0};
+  double min_ttc_s{0.0};
+  double aeb_time_s{0.0};
+  double a_cmd_min_mps2{0.0};
+  double a_cmd_max_mps2{0.0};
+  std::size_t jerk_samples{0};
+  double max_jerk_total_mps3{0.0};
+  double max_jerk_comfort_mps3{0.0};
+  double max_jerk_emergency_mps3{0.0};
+  double cruise_ss_speed_err_mps{0.0};
+  double follow_ss_tgap_err_s{0.0};
+};
+
+class KpiAccumulator {
+ public:
+  // t_end_s: time of the last sample (steady-state windows are measured back from it)
+  KpiAccumulator(const acc::Config& cfg, double t_end_s);
+
+  void add(const Sample& s);
+  Kpis result() const;
+
+ private:
+  double Ts_;
+  double ttc_warn_;
+  double time_gap_;
+  double d0_;
+  double t_end_;
+
+  Kpis k_{};
+  bool has_prev_{false};
+  double prev_a_{0.0};
+  acc::Mode prev_mode_{acc::Mode::OFF};
+
+  double cruise_err_sum_{0.0};
+  double cruise_err_n_{0.0};
+  double tgap_err_sum_{0.0};
+  double tgap_err_n_{0.0};
+};
+
+// Report in the evaluate_kpis.py text format ("key: value" lines).
+void write_kpi_report(std::ostream& os, const Kpis& k, double ttc_warn_s);
+
+}  // namespace sim
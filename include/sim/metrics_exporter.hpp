@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "acc/metrics.hpp"
+
+namespace sim {
+
+// Prometheus text exposition format (version 0.0.4) of a metrics snapshot.
+std::string to_prometheus(const acc::MetricsSnapshot& m);
+
+struct ExporterOptions {
+  std::string file_path;  // periodic snapshot (written to <path>.tmp, then renamed); "" = off
+  std::chrono::milliseconds period{1000};
+  int http_port{-1};  // serve GET on 127.0.0.1:<port> (0 = any free port); < 0 = off
+};
+
+// Reader thread publishing acc::Metrics while the simulation keeps running. It only takes
+// snapshots, so the writers in Function::step never wait on it.
+class MetricsExporter {
+ public:
+  explicit MetricsExporter(const acc::Metrics& metrics) : metrics_(metrics) {}
+  ~MetricsExporter() { stop(); }
+
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  // false if the HTTP port cannot be bound (or HTTP is unsupported on this platform)
+  bool start(const ExporterOptions& opt);
+
+  // Joins the thread; the file (if any) gets a final snapshot.
+  void stop();
+
+  int http_port() const { return port_; }
+
+ private:
+  void run();
+  void write_file() const;
+
+  const acc::Metrics& metrics_;
+  ExporterOptions opt_{};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+  int listen_fd_{-1};
+  int port_{-1};
+};
+
+// Runner setup for --metrics-file PATH, --metrics-port N and --metrics-period-ms MS (raw flag
+// values). Starts `exporter` if a file or port is given and returns whether it runs. Throws
+// std::invalid_argument for a malformed number, std::runtime_error if the port cannot be served.
+bool start_exporter(MetricsExporter& exporter, const std::string& file_path,
+                    const std::string& port, const std::string& period_ms);
+
+}  // namespace sim
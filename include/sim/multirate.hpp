@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+
+#include "acc/config.hpp"
+#include "acc/metrics.hpp"
+#include "sim/closed_loop.hpp"
+#include "sim/scenario.hpp"
+
+namespace sim {
+
+// Decoupled rates for the closed loop. Every rate is a self-rescheduling event in one priority
+// queue (integer microsecond time), so a slow rate costs nothing between its events.
+struct MultiRateOptions {
+  double plant_dt_s{0.001};       // plant integration step
+  double controller_dt_s{0.02};   // Function::step period (also used as Config::Ts_s)
+  double sensor_dt_s{0.05};       // lead sensor update period (sample-and-hold in between)
+  double sensor_latency_s{0.0};   // measurement -> available to the controller
+  bool aeb_enable{true};
+  acc::Metrics* metrics{nullptr};
+};
+
+struct MultiRateStats {
+  std::size_t controller_steps{0};
+  std::size_t plant_steps{0};
+  std::size_t sensor_samples{0};
+};
+
+// Runs the scenario with the options above. One Sample per controller step: `in` is what the
+// controller saw (held lead measurement), while ego_speed_mps, lead_distance_m (held) and
+// lead_gap_m are read once the plant has stepped to the next controller tick, as in
+// run_closed_loop. A distance override is applied on the first plant step of its row only.
+// With all three periods equal to Ts and no latency the samples match run_closed_loop (up to
+// rounding in t_s).
+MultiRateStats run_multirate(const Scenario& sc, const acc::Config& cfg,
+                             const MultiRateOptions& opt, const SampleSink& sink);
+
+}  // namespace sim
@@ -0,0 +1,25 @@
+#pragma once
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace sim {
+
+// Parses a command-line value as a number in [lo, hi]. The whole string must parse: "20x",
+// " 20", "-1" for an unsigned T, overflow, nan and inf throw std::invalid_argument with the
+// message "<flag> '<value>'" (the runners print it after "Invalid argument: ").
+template <typename T>
+T parse_number(const std::string& flag, const std::string& s,
+               T lo = std::numeric_limits<T>::lowest(), T hi = std::numeric_limits<T>::max()) {
+  T v{};
+  const char* end = s.data() + s.size();
+  const auto r = std::from_chars(s.data(), end, v);
+  if (s.empty() || r.ec != std::errc() || r.ptr != end || !(v >= lo && v <= hi)) {
+    throw std::invalid_argument(flag + " '" + s + "'");
+  }
+  return v;
+}
+
+}  // namespace sim
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace sim {
@@ -26,8 +27,16 @@ struct Scenario {
 
   double duration_s() const;
   Row sample(double t_s) const;  // piecewise-linear for speeds, stepwise for lead_valid
+
+  // Latest time T >= t_s such that sample() is constant on [t_s, T] (conservative,
+  // distance overrides count as changes). May be +inf.
+  double steady_until(double t_s) const;
 };
 
 Scenario load_csv(const std::string& path);
 
+// Writes the load_csv format; extra numeric "# key=value" lines are emitted after the metadata.
+void save_csv(const std::string& path, const Scenario& sc,
+              const std::vector<std::pair<std::string, double>>& extra_meta = {});
+
 }  // namespace sim
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "sim/closed_loop.hpp"
+
+namespace sim {
+
+// Trace CSV layout read by tools/evaluate_kpis.py and tools/plot_results.py (by header name,
+// so any subset in any order is readable; evaluate_kpis.py needs t_s, mode, lead_valid,
+// lead_distance_m, ttc_s, a_cmd_mps2 and ego_speed_mps, plus ticks for fast-forward runs).
+enum class TraceColumn {
+  T_S,
+  MODE,
+  EGO_SPEED_MPS,
+  V_SET_MPS,
+  LEAD_VALID,
+  LEAD_DISTANCE_M,
+  LEAD_REL_SPEED_MPS,
+  A_CMD_MPS2,
+  TTC_S,
+  D_DES_M,
+  DISTANCE_ERROR_M,
+  A_CRUISE_MPS2,
+  A_FOLLOW_MPS2,
+  TICKS,  // Sample::ticks; not among the default columns
+};
+constexpr std::size_t kNumTraceColumns = 14;
+constexpr std::size_t kNumDefaultTraceColumns = 13;  // all but TICKS
+
+const char* trace_column_name(TraceColumn c);
+
+// "t_s, a_cmd_mps2,..." -> columns (names are trimmed); throws std::invalid_argument on an
+// unknown name.
+std::vector<TraceColumn> parse_trace_columns(const std::string& names);
+
+struct TraceFormat {
+  std::vector<TraceColumn> columns{};  // empty -> the default columns, in the enum order
+  int precision{6};       // significant digits (%g style); 0 -> shortest round-trip
+  std::size_t every_n{1};  // keep every n-th sample (the KPIs assume n = 1)
+};
+
+// Runner flags --columns t_s,mode,... (empty -> all), --precision P and --every N as given on
+// the command line; throws std::invalid_argument on an unknown column or a malformed number.
+TraceFormat parse_trace_format(const std::string& columns, const std::string& precision,
+                               const std::string& every);
+
+// Appends the ticks column (to the default columns if none are chosen) unless present. Traces of
+// fast-forward runs need it for their summary rows.
+void add_ticks_column(TraceFormat& fmt);
+
+// Locale-free CSV formatting with std::to_chars straight into caller memory.
+class TraceFormatter {
+ public:
+  explicit TraceFormatter(TraceFormat fmt = {});
+
+  std::string header() const;  // with trailing newline
+  std::size_t max_row_bytes() const { return max_row_bytes_; }
+  // Writes one row (with newline) at p, which needs max_row_bytes() of room; returns the end.
+  char* row(char* p, const Sample& s) const;
+
+  const TraceFormat& format() const { return fmt_; }
+
+ private:
+  TraceFormat fmt_;
+  std::size_t max_row_bytes_;
+};
+
+// Formats rows into one reusable buffer and hands it to the stream in large writes.
+class TraceWriter {
+ public:
+  TraceWriter(std::ostream& os, TraceFormat fmt = {}, std::size_t buffer_bytes = 1 << 20);
+  ~TraceWriter() { flush(); }
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  void add(const Sample& s);  // subject to every_n
+  void flush();
+
+ private:
+  std::ostream& os_;
+  TraceFormatter fmt_;
+  std::vector<char> buf_;
+  std::size_t used_{0};
+  std::size_t seen_{0};
+};
+
+// Single header/row with the default columns at the default precision.
+void write_trace_header(std::ostream& os);
+void write_trace_row(std::ostream& os, const Sample& s);
+
+}  // namespace sim
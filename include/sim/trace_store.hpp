@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/bounded_queue.hpp"
+#include "sim/closed_loop.hpp"
+#include "sim/trace_csv.hpp"
+
+namespace sim {
+
+// Fixed-capacity byte block; size is the filled part.
+struct ArenaBlock {
+  std::unique_ptr<char[]> data;
+  std::size_t size{0};
+};
+
+// Free list of equally sized blocks shared by all arenas and the store. Blocks go
+// arena -> store -> pool, so a long sweep stops allocating once the pipeline is warm.
+class BlockPool {
+ public:
+  explicit BlockPool(std::size_t block_bytes) : block_bytes_(block_bytes > 0 ? block_bytes : 1) {}
+
+  ArenaBlock acquire();
+  void release(std::vector<ArenaBlock>& blocks);  // leaves blocks empty
+
+  std::size_t block_bytes() const { return block_bytes_; }
+
+ private:
+  std::size_t block_bytes_;
+  std::mutex m_;
+  std::vector<std::unique_ptr<char[]>> free_;
+};
+
+// Trace text of one run.
+struct ArenaRun {
+  std::vector<ArenaBlock> blocks;
+  std::size_t bytes{0};
+  std::size_t rows{0};
+};
+
+// Per-worker trace buffer. Rows are formatted straight into pool blocks (no locks, no
+// syscalls); take() hands the finished run over as a list of blocks.
+class TraceArena : private std::streambuf {
+ public:
+  explicit TraceArena(BlockPool& pool, TraceFormat fmt = {});
+  ~TraceArena() override;
+
+  TraceArena(const TraceArena&) = delete;
+  TraceArena& operator=(const TraceArena&) = delete;
+
+  void begin_run();           // trace header
+  void add(const Sample& s);  // subject to every_n
+  ArenaRun take();
+
+ private:
+  int_type overflow(int_type c) override;
+  void seal();  // moves the current block into run_
+
+  BlockPool& pool_;
+  std::ostream os_;
+  TraceFormatter fmt_;
+  std::vector<char> scratch_;  // rows that do not fit a whole block
+  ArenaBlock cur_{};
+  ArenaRun run_{};
+  std::size_t seen_{0};
+};
+
+// Where a run's trace ended up: bytes [offset, offset + bytes) of path.
+struct StoredTrace {
+  std::string path;
+  std::uint64_t offset{0};
+  std::uint64_t bytes{0};
+  std::size_t rows{0};
+  std::string error;  // empty on success
+};
+
+// Single background writer for arena runs. With an empty pack_path every run goes to its own
+// file in one open/writev/close; otherwise all runs are appended to pack_path, and whatever
+// runs are queued at the time are flushed together in one sequential writev.
+class TraceStore {
+ public:
+  TraceStore(BlockPool& pool, std::string pack_path, std::size_t queue_depth);
+  ~TraceStore() { finish(); }
+
+  TraceStore(const TraceStore&) = delete;
+  TraceStore& operator=(const TraceStore&) = delete;
+
+  // Thread-safe; blocks while queue_depth runs are waiting. path is ignored when packing.
+  void submit(std::size_t id, std::string path, ArenaRun run);
+
+  // Writes what is queued, joins the writer and returns the location of every run by id.
+  std::map<std::size_t, StoredTrace> finish();
+
+ private:
+  struct Item {
+    std::size_t id{0};
+    std::string path;
+    ArenaRun run;
+  };
+  void run();
+  void write_files(std::vector<Item>& batch);
+  void write_pack(std::vector<Item>& batch);
+
+  BlockPool& pool_;
+  std::string pack_path_;
+  BoundedQueue<Item> queue_;
+  std::map<std::size_t, StoredTrace> stored_;
+  std::uint64_t pack_offset_{0};
+  int pack_fd_{-1};
+  std::string pack_error_;
+  std::thread thread_;
+};
+
+}  // namespace sim
@@ -2,6 +2,7 @@
 #include "acc/limiters.hpp"
 #include "acc/plausibility.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
 
@@ -17,6 +18,30 @@ static double compute_ttc(const Input& in) {
 }
 
 Output Function::step(const Input& in) {
+  if (metrics_ == nullptr) return step_impl(in);
+
+  const Output prev = prev_out_;
+  using clock = std::chrono::steady_clock;
+  const bool timed = metrics_->latency_due();
+  const auto t0 = timed ? clock::now() : clock::time_point{};
+
+  const Output out = step_impl(in);
+
+  if (timed) {
+    const auto dt = clock::now() - t0;
+    metrics_->record_latency_ns(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+  }
+
+  const bool aeb_involved = (out.mode == Mode::AEB) || (prev.mode == Mode::AEB);
+  const double jerk =
+      aeb_involved ? 0.0 : std::abs(out.a_cmd_mps2 - prev.a_cmd_mps2) / cfg_.Ts_s;
+  metrics_->record_step(out.mode, out.mode == Mode::AEB && prev.mode != Mode::AEB, out.ttc_s,
+                        jerk);
+  return out;
+}
+
+Output Function::step_impl(const Input& in) {
   Output out{};
   out.ttc_s = compute_ttc(in);
 
@@ -0,0 +1,203 @@
+#include "acc/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace acc {
+
+static_assert(std::atomic<double>::is_always_lock_free, "Metrics requires lock-free doubles");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Metrics requires lock-free 64-bit counters");
+
+// Exclusive shards have a single writer, so a relaxed load + store is enough; the shared
+// overflow shard needs real read-modify-write.
+template <typename T>
+static void add(std::atomic<T>& a, T n, bool exclusive) {
+  if (exclusive) {
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  } else {
+    a.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, typename Better>
+static void improve(std::atomic<T>& a, T v, bool exclusive, Better better) {
+  T cur = a.load(std::memory_order_relaxed);
+  if (!better(v, cur)) return;
+  if (exclusive) {
+    a.store(v, std::memory_order_relaxed);
+    return;
+  }
+  while (better(v, cur) && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+  }
+}
+
+template <typename T>
+static void atomic_min(std::atomic<T>& a, T v, bool exclusive) {
+  improve(a, v, exclusive, [](T x, T y) { return x < y; });
+}
+
+template <typename T>
+static void atomic_max(std::atomic<T>& a, T v, bool exclusive) {
+  improve(a, v, exclusive, [](T x, T y) { return x > y; });
+}
+
+static std::atomic<std::uint64_t> g_next_registry_id{0};
+
+// Live registries by id. Shard claims and releases are rare (first use on a thread, thread exit),
+// so one lock covers them together with every registry's shard bookkeeping.
+static std::mutex& registry_mutex() {
+  static std::mutex m;
+  return m;
+}
+
+static std::map<std::uint64_t, Metrics*>& live_registries() {
+  static std::map<std::uint64_t, Metrics*> live;
+  return live;
+}
+
+// Shards held by one thread, one per registry it wrote to; returned when the thread exits.
+class ShardClaims {
+ public:
+  ShardClaims() = default;
+  ShardClaims(const ShardClaims&) = delete;
+  ShardClaims& operator=(const ShardClaims&) = delete;
+
+  ~ShardClaims() {
+    std::lock_guard<std::mutex> lk(registry_mutex());
+    for (const Claim& c : held_) release(c);
+  }
+
+  Metrics::Writer get(Metrics& m) {
+    for (const Claim& c : held_) {
+      if (c.id == m.id_) return c.writer;
+    }
+    std::lock_guard<std::mutex> lk(registry_mutex());
+    // drop claims on registries destroyed since
+    const auto& live = live_registries();
+    held_.erase(std::remove_if(held_.begin(), held_.end(),
+                               [&](const Claim& c) { return live.count(c.id) == 0; }),
+                held_.end());
+
+    std::size_t idx = Metrics::kShards - 1;
+    if (!m.free_shards_.empty()) {
+      idx = m.free_shards_.back();
+      m.free_shards_.pop_back();
+    } else if (m.next_shard_ < Metrics::kShards - 1) {
+      idx = m.next_shard_++;
+    }
+    const bool exclusive = idx < Metrics::kShards - 1;
+    held_.push_back(Claim{m.id_, idx, Metrics::Writer{&m.shards_[idx], exclusive}});
+    return held_.back().writer;
+  }
+
+ private:
+  struct Claim {
+    std::uint64_t id;
+    std::size_t idx;
+    Metrics::Writer writer;
+  };
+
+  // caller holds registry_mutex()
+  static void release(const Claim& c) {
+    if (!c.writer.exclusive) return;
+    const auto it = live_registries().find(c.id);
+    if (it != live_registries().end()) it->second->free_shards_.push_back(c.idx);
+  }
+
+  std::vector<Claim> held_;
+};
+
+Metrics::Metrics(std::uint32_t latency_sample_every)
+    : id_(g_next_registry_id.fetch_add(1, std::memory_order_relaxed)),
+      latency_sample_every_(latency_sample_every > 0 ? latency_sample_every : 1) {
+  std::lock_guard<std::mutex> lk(registry_mutex());
+  live_registries().emplace(id_, this);
+}
+
+Metrics::~Metrics() {
+  std::lock_guard<std::mutex> lk(registry_mutex());
+  live_registries().erase(id_);
+}
+
+Metrics::Writer Metrics::local() {
+  // last registry used on this thread first; the claim set covers threads alternating registries
+  thread_local std::uint64_t cached_id = ~std::uint64_t{0};
+  thread_local Writer cached{nullptr, false};
+  if (cached_id != id_) {
+    thread_local ShardClaims claims;
+    cached = claims.get(*this);
+    cached_id = id_;
+  }
+  return cached;
+}
+
+std::size_t Metrics::exclusive_writers() const {
+  std::lock_guard<std::mutex> lk(registry_mutex());
+  return next_shard_ - free_shards_.size();
+}
+
+void Metrics::record_step(Mode mode, bool aeb_entered, double ttc_s, double jerk_mps3) {
+  const Writer w = local();
+  Shard& s = *w.shard;
+  add<std::uint64_t>(s.steps, 1, w.exclusive);
+  add<std::uint64_t>(s.mode_ticks[static_cast<std::size_t>(mode)], 1, w.exclusive);
+  if (aeb_entered) add<std::uint64_t>(s.aeb_activations, 1, w.exclusive);
+  atomic_min(s.ttc_min_s, ttc_s, w.exclusive);
+  atomic_max(s.jerk_peak_mps3, jerk_mps3, w.exclusive);
+}
+
+void Metrics::record_ticks(Mode mode, std::uint64_t n) {
+  const Writer w = local();
+  add(w.shard->mode_ticks[static_cast<std::size_t>(mode)], n, w.exclusive);
+}
+
+bool Metrics::latency_due() {
+  const Writer w = local();
+  std::atomic<std::uint32_t>& tick = w.shard->latency_tick;
+  std::uint32_t n = 0;
+  if (w.exclusive) {
+    n = tick.load(std::memory_order_relaxed);
+    tick.store(n + 1, std::memory_order_relaxed);
+  } else {
+    n = tick.fetch_add(1, std::memory_order_relaxed);
+  }
+  return n % latency_sample_every_ == 0;
+}
+
+void Metrics::record_latency_ns(std::uint64_t ns) {
+  const auto& bounds = MetricsSnapshot::kLatencyBoundsNs;
+  const auto bucket =
+      static_cast<std::size_t>(std::lower_bound(bounds.begin(), bounds.end(), ns) - bounds.begin());
+
+  const Writer w = local();
+  Shard& s = *w.shard;
+  add<std::uint64_t>(s.latency_buckets[bucket], 1, w.exclusive);
+  add<std::uint64_t>(s.latency_count, 1, w.exclusive);
+  add(s.latency_sum_ns, ns, w.exclusive);
+  atomic_max(s.latency_max_ns, ns, w.exclusive);
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+  MetricsSnapshot m{};
+  m.ttc_min_s = std::numeric_limits<double>::infinity();
+  for (const Shard& s : shards_) {
+    m.steps += s.steps.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kNumModes; ++i) {
+      m.mode_ticks[i] += s.mode_ticks[i].load(std::memory_order_relaxed);
+    }
+    m.aeb_activations += s.aeb_activations.load(std::memory_order_relaxed);
+    m.ttc_min_s = std::min(m.ttc_min_s, s.ttc_min_s.load(std::memory_order_relaxed));
+    m.jerk_peak_mps3 = std::max(m.jerk_peak_mps3, s.jerk_peak_mps3.load(std::memory_order_relaxed));
+    for (std::size_t i = 0; i < MetricsSnapshot::kLatencyBuckets; ++i) {
+      m.latency_buckets[i] += s.latency_buckets[i].load(std::memory_order_relaxed);
+    }
+    m.latency_count += s.latency_count.load(std::memory_order_relaxed);
+    m.latency_sum_ns += s.latency_sum_ns.load(std::memory_order_relaxed);
+    m.latency_max_ns = std::max(m.latency_max_ns, s.latency_max_ns.load(std::memory_order_relaxed));
+  }
+  return m;
+}
+
+}  // namespace acc
@@ -0,0 +1,268 @@
+#include "sim/campaign.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "sim/bounded_queue.hpp"
+#include "sim/scenario.hpp"
+#include "sim/trace_store.hpp"
+
+namespace sim {
+
+namespace {
+
+struct Job {
+  std::size_t id{0};
+  std::shared_ptr<const Scenario> sc;
+  acc::Config cfg{};
+  std::string error;
+};
+
+// Batch of consecutive samples of one run. The first batch carries what the KPI stage needs,
+// the last one carries the run's outcome.
+struct Chunk {
+  std::size_t id{0};
+  bool first{false};
+  bool last{false};
+  acc::Config cfg{};
+  double t_end_s{0.0};
+  std::vector<Sample> samples;
+  Kpis kpis{};
+  std::string error;
+};
+
+// 64-bit FNV-1a over the little-endian bytes of each field (struct padding never enters).
+class Fnv1a {
+ public:
+  void add(double x) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &x, sizeof(bits));
+    add(bits);
+  }
+  void add(std::uint64_t x) {
+    for (int i = 0; i < 8; ++i) {
+      h_ ^= (x >> (8 * i)) & 0xffU;
+      h_ *= 0x100000001b3ULL;
+    }
+  }
+  std::uint64_t value() const { return h_; }
+
+ private:
+  std::uint64_t h_{0xcbf29ce484222325ULL};
+};
+
+}  // namespace
+
+std::uint64_t config_hash(const acc::Config& c, const RunOptions& run) {
+  Fnv1a h;
+  for (const double x :
+       {c.v_set_mps, c.time_gap_s, c.standstill_offset_m, c.a_max_mps2, c.a_min_mps2,
+        c.jerk_max_mps3, c.jerk_max_emergency_mps3, c.ttc_warn_s, c.ttc_aeb_s, c.max_distance_m,
+        c.max_abs_rel_speed_mps, c.cruise_kp, c.cruise_ki, c.cruise_i_min, c.cruise_i_max,
+        c.follow_kp_dist, c.follow_kd_rel}) {
+    h.add(x);
+  }
+  h.add(std::uint64_t{run.aeb_enable});
+  h.add(std::uint64_t{run.fast_forward});
+  if (run.fast_forward) h.add(run.ff_max_skip_s);
+  return h.value();
+}
+
+static std::string hash_hex(std::uint64_t h) {
+  char buf[17];
+  std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+  return buf;
+}
+
+static void load_stage(const std::vector<std::string>& paths,
+                       const std::vector<acc::Config>& configs, BoundedQueue<Job>& jobs) {
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    auto sc = std::make_shared<Scenario>();
+    std::string error;
+    try {
+      *sc = load_csv(paths[i]);
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+    for (std::size_t j = 0; j < configs.size(); ++j) {
+      Job job{};
+      job.id = i * configs.size() + j;
+      job.sc = sc;
+      job.cfg = configs[j];
+      job.error = error;
+      if (!jobs.push(std::move(job))) {
+        jobs.close();
+        return;
+      }
+    }
+  }
+  jobs.close();
+}
+
+static void sim_stage(const CampaignOptions& opt, const std::vector<CampaignResult>& results,
+                      BoundedQueue<Job>& jobs, BoundedQueue<Chunk>& traces, BlockPool& pool,
+                      TraceStore& store) {
+  TraceFormat fmt = opt.trace;
+  if (opt.run.fast_forward) add_ticks_column(fmt);
+  TraceArena arena(pool, std::move(fmt));
+  while (auto job = jobs.pop()) {
+    Chunk c{};
+    c.id = job->id;
+    c.first = true;
+
+    if (job->error.empty()) {
+      c.cfg = job->cfg;
+      c.cfg.Ts_s = job->sc->meta.Ts_s;
+      const auto n_ticks =
+          static_cast<std::size_t>(std::floor(job->sc->duration_s() / c.cfg.Ts_s + 1e-9));
+      c.t_end_s = static_cast<double>(n_ticks) * c.cfg.Ts_s;
+      c.samples.reserve(opt.chunk_samples);
+      arena.begin_run();
+      try {
+        run_closed_loop(*job->sc, c.cfg, opt.run, [&](const Sample& s) {
+          arena.add(s);
+          c.samples.push_back(s);
+          if (c.samples.size() >= opt.chunk_samples) {
+            Chunk next{};
+            next.id = c.id;
+            next.cfg = c.cfg;
+            next.samples.reserve(opt.chunk_samples);
+            traces.push(std::exchange(c, std::move(next)));
+          }
+        });
+      } catch (const std::exception& e) {
+        c.error = e.what();
+      }
+      store.submit(c.id, results[c.id].trace_path, arena.take());
+    } else {
+      c.error = job->error;
+    }
+
+    c.last = true;
+    traces.push(std::move(c));
+  }
+}
+
+static void kpi_stage(BoundedQueue<Chunk>& traces, BoundedQueue<Chunk>& out) {
+  std::map<std::size_t, KpiAccumulator> acc;
+  while (auto c = traces.pop()) {
+    if (c->first) acc.emplace(c->id, KpiAccumulator(c->cfg, c->t_end_s));
+    auto& a = acc.at(c->id);
+    for (const auto& s : c->samples) a.add(s);
+    if (c->last) {
+      c->kpis = a.result();
+      acc.erase(c->id);
+    }
+    out.push(std::move(*c));
+  }
+  out.close();
+}
+
+static void write_index(std::ostream& os, const std::vector<CampaignResult>& results) {
+  os << "scenario,config_hash,trace_path,trace_offset,trace_bytes,min_distance_m,min_ttc_s,"
+        "aeb_time_s,max_jerk_comfort_mps3,max_jerk_emergency_mps3,cruise_ss_speed_err_mps,"
+        "follow_ss_tgap_err_s,error\n";
+  for (const auto& r : results) {
+    const auto& k = r.kpis;
+    std::string error = r.error;
+    std::replace(error.begin(), error.end(), ',', ';');
+    os << r.scenario_path << "," << hash_hex(r.config_hash) << "," << r.trace_path << ","
+       << r.trace_offset << "," << r.trace_bytes << "," << k.min_distance_m << "," << k.min_ttc_s
+       << "," << k.aeb_time_s << "," << k.max_jerk_comfort_mps3 << ","
+       << k.max_jerk_emergency_mps3 << "," << k.cruise_ss_speed_err_mps << ","
+       << k.follow_ss_tgap_err_s << "," << error << "\n";
+  }
+}
+
+std::vector<CampaignResult> run_campaign(const std::vector<std::string>& scenario_paths,
+                                         const CampaignOptions& opt) {
+  namespace fs = std::filesystem;
+
+  const std::vector<acc::Config> configs =
+      opt.configs.empty() ? std::vector<acc::Config>{acc::Config{}} : opt.configs;
+  const fs::path pack_path = fs::path(opt.out_dir) / "traces.pack";
+  const fs::path index_path = fs::path(opt.out_dir) / "index.csv";
+
+  const bool write_reports = opt.kpi_reports && !opt.pack_traces;
+
+  std::vector<CampaignResult> results(scenario_paths.size() * configs.size());
+  for (std::size_t i = 0; i < scenario_paths.size(); ++i) {
+    for (std::size_t j = 0; j < configs.size(); ++j) {
+      auto& r = results[i * configs.size() + j];
+      r.scenario_path = scenario_paths[i];
+      r.config_hash = config_hash(configs[j], opt.run);
+
+      std::string name = (fs::path(opt.out_dir) / fs::path(scenario_paths[i]).stem()).string();
+      if (configs.size() > 1) name += "_" + hash_hex(r.config_hash);
+      r.trace_path = opt.pack_traces ? pack_path.string() : name + ".csv";
+      r.report_path = write_reports ? name + "_kpi.txt" : index_path.string();
+    }
+  }
+
+  std::error_code ec;
+  fs::create_directories(opt.out_dir, ec);
+
+  std::size_t workers = opt.sim_workers;
+  if (workers == 0) workers = std::max(1U, std::thread::hardware_concurrency());
+  workers = std::min(workers, std::max<std::size_t>(1, results.size()));
+
+  BoundedQueue<Job> jobs(opt.queue_depth);
+  BoundedQueue<Chunk> traces(opt.queue_depth);
+  BoundedQueue<Chunk> evaluated(opt.queue_depth);
+  BlockPool pool(opt.arena_block_bytes);
+  TraceStore store(pool, opt.pack_traces ? pack_path.string() : std::string(), opt.queue_depth);
+
+  std::thread loader(load_stage, std::cref(scenario_paths), std::cref(configs), std::ref(jobs));
+
+  std::atomic<std::size_t> sims_running{workers};
+  std::vector<std::thread> sims;
+  for (std::size_t i = 0; i < workers; ++i) {
+    sims.emplace_back([&] {
+      sim_stage(opt, results, jobs, traces, pool, store);
+      if (--sims_running == 0) traces.close();
+    });
+  }
+
+  std::thread evaluator(kpi_stage, std::ref(traces), std::ref(evaluated));
+
+  // KPIs always go into index.csv; optional per-run reports are written on the calling thread.
+  while (auto c = evaluated.pop()) {
+    if (!c->last) continue;
+    auto& r = results[c->id];
+    r.error = c->error;
+    if (!r.error.empty()) continue;
+    r.kpis = c->kpis;
+    if (!write_reports) continue;
+    std::ofstream rep(r.report_path);
+    if (rep) {
+      write_kpi_report(rep, r.kpis, c->cfg.ttc_warn_s);
+    } else {
+      r.error = "Cannot open output file: " + r.report_path;
+    }
+  }
+
+  loader.join();
+  for (auto& t : sims) t.join();
+  evaluator.join();
+
+  for (const auto& [id, st] : store.finish()) {
+    auto& r = results[id];
+    r.trace_offset = st.offset;
+    r.trace_bytes = st.bytes;
+    if (r.error.empty()) r.error = st.error;
+  }
+
+  std::ofstream index(index_path);
+  if (index) write_index(index, results);
+  return results;
+}
+
+}  // namespace sim
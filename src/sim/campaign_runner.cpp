@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "acc/config.hpp"
+#include "acc/metrics.hpp"
+#include "sim/campaign.hpp"
+#include "sim/metrics_exporter.hpp"
+#include "sim/parse_number.hpp"
+#include "sim/trace_csv.hpp"
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::string(argv[i]) == key) return std::string(argv[i + 1]);
+  }
+  return def;
+}
+
+static bool has_flag(int argc, char** argv, const std::string& key) {
+  for (int i = 1; i < argc; ++i) if (std::string(argv[i]) == key) return true;
+  return false;
+}
+
+int main(int argc, char** argv) {
+  const std::string scenario_dir = get_arg(argc, argv, "--scenarios", "scenarios");
+  const std::string out_dir      = get_arg(argc, argv, "--out-dir", "results/campaign");
+
+  int jobs = 0;
+  try {
+    jobs = sim::parse_number<int>("--jobs", get_arg(argc, argv, "--jobs", "0"));
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+
+  std::vector<std::string> paths;
+  std::error_code ec;
+  for (const auto& e : std::filesystem::directory_iterator(scenario_dir, ec)) {
+    if (e.is_regular_file() && e.path().extension() == ".csv") paths.push_back(e.path().string());
+  }
+  if (ec || paths.empty()) {
+    std::cerr << "No scenarios found in: " << scenario_dir << "\n";
+    return 1;
+  }
+  std::sort(paths.begin(), paths.end());
+
+  sim::CampaignOptions opt;
+  opt.out_dir = out_dir;
+  opt.sim_workers = static_cast<std::size_t>(std::max(0, jobs));
+  opt.run.aeb_enable = !has_flag(argc, argv, "--no-aeb");
+  opt.run.fast_forward = has_flag(argc, argv, "--fast-forward");
+  opt.pack_traces = has_flag(argc, argv, "--pack");
+  opt.kpi_reports = has_flag(argc, argv, "--kpi-reports");
+  try {
+    opt.trace = sim::parse_trace_format(get_arg(argc, argv, "--columns", ""),
+                                        get_arg(argc, argv, "--precision", "6"),
+                                        get_arg(argc, argv, "--every", "1"));
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+
+  // --time-gaps 1.2,1.5,2.0 sweeps acc::Config::time_gap_s over every scenario
+  std::stringstream gaps(get_arg(argc, argv, "--time-gaps", ""));
+  try {
+    for (std::string g; std::getline(gaps, g, ',');) {
+      acc::Config cfg;
+      const double positive = std::numeric_limits<double>::min();
+      cfg.time_gap_s = sim::parse_number("--time-gaps", g, positive);
+      opt.configs.push_back(cfg);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+
+  acc::Metrics metrics;
+  sim::MetricsExporter exporter(metrics);
+  try {
+    if (sim::start_exporter(exporter, get_arg(argc, argv, "--metrics-file", ""),
+                            get_arg(argc, argv, "--metrics-port", "-1"),
+                            get_arg(argc, argv, "--metrics-period-ms", "1000"))) {
+      opt.run.metrics = &metrics;
+    }
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  if (exporter.http_port() >= 0) {
+    std::cout << "Metrics: http://127.0.0.1:" << exporter.http_port() << "/metrics\n";
+  }
+
+  const auto results = sim::run_campaign(paths, opt);
+  exporter.stop();
+
+  int failed = 0;
+  std::printf("%-40s %16s %14s %10s %10s\n", "scenario", "config", "min_distance_m", "min_ttc_s",
+              "aeb_time_s");
+  for (const auto& r : results) {
+    if (!r.error.empty()) {
+      std::fprintf(stderr, "%s: %s\n", r.scenario_path.c_str(), r.error.c_str());
+      ++failed;
+      continue;
+    }
+    std::printf("%-40s %016llx %14.3f %10.3f %10.3f\n", r.scenario_path.c_str(),
+                static_cast<unsigned long long>(r.config_hash), r.kpis.min_distance_m,
+                r.kpis.min_ttc_s, r.kpis.aeb_time_s);
+  }
+
+  std::cout << "Wrote: " << out_dir << " (" << results.size() - failed << "/" << results.size()
+            << " runs, index.csv)\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "sim/falsify.hpp"
+#include "sim/parse_number.hpp"
+
+static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::string(argv[i]) == key) return std::string(argv[i + 1]);
+  }
+  return def;
+}
+
+int main(int argc, char** argv) {
+  const std::string objective = get_arg(argc, argv, "--objective", "min-distance");
+  const std::string out_dir   = get_arg(argc, argv, "--out-dir", "results/falsified");
+
+  sim::FalsifyOptions opt;
+  if (objective == "min-distance") {
+    opt.objective = sim::FalsifyObjective::MIN_DISTANCE;
+  } else if (objective == "false-aeb") {
+    opt.objective = sim::FalsifyObjective::FALSE_AEB;
+  } else {
+    std::cerr << "Unknown objective: " << objective << " (min-distance | false-aeb)\n";
+    return 1;
+  }
+
+  try {
+    using Count = std::size_t;
+    opt.iterations = sim::parse_number<Count>("--iterations",
+                                              get_arg(argc, argv, "--iterations", "20"), 1);
+    opt.population = sim::parse_number<Count>("--population",
+                                              get_arg(argc, argv, "--population", "64"), 1);
+    opt.workers = sim::parse_number<Count>("--jobs", get_arg(argc, argv, "--jobs", "0"));
+    opt.seed = sim::parse_number<std::uint64_t>("--seed", get_arg(argc, argv, "--seed", "1"));
+    opt.keep = sim::parse_number<Count>("--keep", get_arg(argc, argv, "--keep", "5"), 1);
+    opt.duration_s = sim::parse_number("--duration", get_arg(argc, argv, "--duration", "15"),
+                                       std::numeric_limits<double>::min());
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+
+  const acc::Config cfg;
+  const auto worst = sim::falsify(cfg, opt);
+
+  std::error_code ec;
+  std::filesystem::create_directories(out_dir, ec);
+
+  std::printf("%-44s %10s %10s %10s\n", "scenario", "score", "min_gap_m", "aeb_time_s");
+  for (std::size_t i = 0; i < worst.size(); ++i) {
+    const auto& c = worst[i];
+    const auto& p = c.params;
+    const std::string path =
+        (std::filesystem::path(out_dir) / (objective + "_" + std::to_string(i + 1) + ".csv"))
+            .string();
+    try {
+      sim::save_csv(path, sim::make_lead_case(p, opt.duration_s, opt.Ts_s),
+                    {{"falsify_score", c.score},
+                     {"case_lead_speed_mps", p.lead_speed_mps},
+                     {"case_gap_m", p.gap_m},
+                     {"case_cut_in_s", p.cut_in_s},
+                     {"case_brake_start_s", p.brake_start_s},
+                     {"case_brake_decel_mps2", p.brake_decel_mps2},
+                     {"case_dropout_start_s", p.dropout_start_s},
+                     {"case_dropout_len_s", p.dropout_len_s}});
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << "\n";
+      return 1;
+    }
+    std::printf("%-44s %10.3f %10.3f %10.3f\n", path.c_str(), c.score, c.min_gap_m, c.aeb_time_s);
+  }
+
+  std::cout << "Evaluated " << opt.iterations * opt.population << " cases, wrote " << worst.size()
+            << " to " << out_dir << "\n";
+  return 0;
+}
@@ -0,0 +1,290 @@
+#include "sim/falsify.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+
+#include "sim/closed_loop.hpp"
+
+namespace sim {
+
+static constexpr std::size_t kNumParams = 8;
+using ParamVec = std::array<double, kNumParams>;
+
+static ParamVec to_vec(const LeadCaseParams& p) {
+  return {p.ego_speed_mps, p.lead_speed_mps,   p.gap_m,           p.cut_in_s,
+          p.brake_start_s, p.brake_decel_mps2, p.dropout_start_s, p.dropout_len_s};
+}
+
+static LeadCaseParams from_vec(const ParamVec& v) {
+  LeadCaseParams p{};
+  p.ego_speed_mps = v[0];
+  p.lead_speed_mps = v[1];
+  p.gap_m = v[2];
+  p.cut_in_s = v[3];
+  p.brake_start_s = v[4];
+  p.brake_decel_mps2 = v[5];
+  p.dropout_start_s = v[6];
+  p.dropout_len_s = v[7];
+  return p;
+}
+
+static double lead_speed_at(const LeadCaseParams& p, double t) {
+  if (t <= p.brake_start_s) return p.lead_speed_mps;
+  const double v = p.lead_speed_mps - p.brake_decel_mps2 * (t - p.brake_start_s);
+  return (v > 1e-9) ? v : 0.0;
+}
+
+static double snap(double t, double duration_s, double Ts_s) {
+  return std::round(std::clamp(t, 0.0, duration_s) / Ts_s) * Ts_s;
+}
+
+// Time the lead first becomes visible (cut-in), on the Ts grid.
+static double visible_from_s(const LeadCaseParams& p, double duration_s, double Ts_s) {
+  return (p.cut_in_s < 2.0 * Ts_s) ? 0.0 : snap(p.cut_in_s, duration_s, Ts_s);
+}
+
+Scenario make_lead_case(const LeadCaseParams& in, double duration_s, double Ts_s) {
+  auto grid = [&](double t) { return snap(t, duration_s, Ts_s); };
+
+  LeadCaseParams p = in;
+  p.brake_decel_mps2 = std::max(p.brake_decel_mps2, 1e-3);
+  p.cut_in_s = visible_from_s(in, duration_s, Ts_s);
+  p.brake_start_s = grid(p.brake_start_s);
+  const bool dropout = p.dropout_len_s >= 2.0 * Ts_s;
+  const double drop_begin = grid(p.dropout_start_s);
+  const double drop_end = grid(p.dropout_start_s + p.dropout_len_s);
+
+  std::vector<double> ts = {0.0, duration_s, p.brake_start_s,
+                            p.brake_start_s + p.lead_speed_mps / p.brake_decel_mps2};
+  if (p.cut_in_s > 0.0) {
+    ts.push_back(p.cut_in_s);
+    // override only holds for one tick; the end row sits exactly on the next loop tick
+    ts.push_back(std::round(p.cut_in_s / Ts_s + 1.0) * Ts_s);
+  }
+  if (dropout) {
+    ts.push_back(drop_begin);
+    ts.push_back(drop_end);
+  }
+  std::sort(ts.begin(), ts.end());
+
+  Scenario sc{};
+  sc.meta.Ts_s = Ts_s;
+  sc.meta.init_ego_speed_mps = p.ego_speed_mps;
+  sc.meta.init_lead_distance_m = p.gap_m;
+
+  for (const double t : ts) {
+    if (t < 0.0 || t > duration_s) continue;
+    if (!sc.rows.empty() && t - sc.rows.back().t_s < 1e-9) continue;
+
+    Row r{};
+    r.t_s = t;
+    r.lead_valid = t >= p.cut_in_s && !(dropout && t >= drop_begin && t < drop_end);
+    r.v_lead_mps = lead_speed_at(p, t);
+    r.v_set_mps = p.ego_speed_mps;
+    if (p.cut_in_s > 0.0 && std::abs(t - p.cut_in_s) < 1e-9) {
+      r.has_distance_override = true;
+      r.lead_distance_m_override = p.gap_m;
+    }
+    sc.rows.push_back(r);
+  }
+  return sc;
+}
+
+// Ideal reference: ego holds its speed until the lead is visible, then brakes at a_min.
+// That maximises the gap at every later time, so a collision here is unavoidable.
+static bool ideal_brake_avoids(const LeadCaseParams& p, const acc::Config& cfg,
+                               double duration_s, double Ts_s) {
+  const double t0 = visible_from_s(p, duration_s, Ts_s);
+  double v = p.ego_speed_mps;
+  double gap = p.gap_m;
+  for (double t = t0; t <= duration_s; t += Ts_s) {
+    v = std::max(0.0, v + cfg.a_min_mps2 * Ts_s);
+    gap += (lead_speed_at(p, t) - v) * Ts_s;
+    if (gap <= 0.0) return false;
+  }
+  return true;
+}
+
+struct RunSummary {
+  double min_gap_m{std::numeric_limits<double>::infinity()};
+  double impact_speed_mps{0.0};
+  double aeb_time_s{0.0};
+  double min_ttc_s{std::numeric_limits<double>::infinity()};
+};
+
+static RunSummary run_case(const Scenario& sc, const acc::Config& cfg, double visible_from_s,
+                           bool aeb_enable) {
+  RunOptions ro{};
+  ro.aeb_enable = aeb_enable;
+
+  RunSummary r{};
+  run_closed_loop(sc, cfg, ro, [&](const Sample& s) {
+    if (s.out.mode == acc::Mode::AEB) r.aeb_time_s += cfg.Ts_s * s.ticks;
+    if (std::isfinite(s.out.ttc_s)) r.min_ttc_s = std::min(r.min_ttc_s, s.out.ttc_s);
+    if (s.in.t_s < visible_from_s) return;
+    if (s.lead_gap_m <= 0.0 && r.min_gap_m > 0.0) {
+      r.impact_speed_mps = s.ego_speed_mps - sc.sample(s.in.t_s).v_lead_mps;
+    }
+    r.min_gap_m = std::min(r.min_gap_m, s.lead_gap_m);
+  });
+  return r;
+}
+
+FalsifyCase evaluate_lead_case(const LeadCaseParams& p, const acc::Config& cfg_in,
+                               const FalsifyOptions& opt) {
+  acc::Config cfg = cfg_in;
+  cfg.Ts_s = opt.Ts_s;
+
+  const Scenario sc = make_lead_case(p, opt.duration_s, opt.Ts_s);
+  const double visible_from = visible_from_s(p, opt.duration_s, opt.Ts_s);
+
+  FalsifyCase c{};
+  c.params = p;
+  c.feasible = ideal_brake_avoids(p, cfg, opt.duration_s, opt.Ts_s);
+
+  const RunSummary r = run_case(sc, cfg, visible_from, true);
+  c.min_gap_m = r.min_gap_m;
+  c.aeb_time_s = r.aeb_time_s;
+
+  const double inf = std::numeric_limits<double>::infinity();
+  if (opt.objective == FalsifyObjective::MIN_DISTANCE) {
+    // collisions rank by impact speed below every near miss
+    if (!c.feasible) {
+      c.score = inf;
+    } else {
+      c.score = (r.min_gap_m > 0.0) ? r.min_gap_m : -std::max(0.0, r.impact_speed_mps);
+    }
+    return c;
+  }
+
+  // FALSE_AEB: no activation -> distance to the trigger (search gradient), otherwise
+  // -aeb_time if ACC alone would have kept the margin.
+  if (r.aeb_time_s <= 0.0) {
+    c.score = std::min(r.min_ttc_s - cfg.ttc_aeb_s, 100.0);
+    return c;
+  }
+  const RunSummary no_aeb = run_case(sc, cfg, visible_from, false);
+  c.score = (no_aeb.min_gap_m >= opt.false_aeb_margin_m) ? -r.aeb_time_s : inf;
+  return c;
+}
+
+static void evaluate_all(const std::vector<LeadCaseParams>& ps, const acc::Config& cfg,
+                         const FalsifyOptions& opt, std::vector<FalsifyCase>& out) {
+  out.assign(ps.size(), FalsifyCase{});
+
+  std::size_t workers = opt.workers;
+  if (workers == 0) workers = std::max(1U, std::thread::hardware_concurrency());
+  workers = std::min(workers, std::max<std::size_t>(1, ps.size()));
+
+  std::atomic<std::size_t> next{0};
+  auto work = [&] {
+    for (std::size_t i = next++; i < ps.size(); i = next++) {
+      out[i] = evaluate_lead_case(ps[i], cfg, opt);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t w = 1; w < workers; ++w) pool.emplace_back(work);
+  work();
+  for (auto& t : pool) t.join();
+}
+
+std::vector<FalsifyCase> falsify(const acc::Config& cfg, const FalsifyOptions& opt) {
+  const ParamVec lo = to_vec(opt.bounds.lo);
+  const ParamVec hi = to_vec(opt.bounds.hi);
+
+  // Cross-entropy method on the unit cube: sample, keep the elite, refit a diagonal Gaussian.
+  ParamVec mean{};
+  ParamVec sigma{};
+  mean.fill(0.5);
+  sigma.fill(0.3);
+
+  std::mt19937_64 rng(opt.seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  const auto n_elite = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::ceil(opt.elite_frac * static_cast<double>(opt.population))));
+
+  std::vector<std::pair<ParamVec, FalsifyCase>> archive;
+  std::vector<ParamVec> unit(opt.population);
+  std::vector<LeadCaseParams> ps(opt.population);
+  std::vector<FalsifyCase> scored;
+
+  for (std::size_t it = 0; it < opt.iterations; ++it) {
+    for (std::size_t i = 0; i < opt.population; ++i) {
+      for (std::size_t j = 0; j < kNumParams; ++j) {
+        unit[i][j] = std::clamp(mean[j] + sigma[j] * normal(rng), 0.0, 1.0);
+      }
+      ParamVec v{};
+      for (std::size_t j = 0; j < kNumParams; ++j) v[j] = lo[j] + unit[i][j] * (hi[j] - lo[j]);
+      ps[i] = from_vec(v);
+    }
+
+    evaluate_all(ps, cfg, opt, scored);
+
+    std::vector<std::size_t> order(opt.population);
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+      return scored[a].score < scored[b].score;
+    });
+
+    ParamVec m{};
+    ParamVec s2{};
+    std::size_t n = 0;
+    for (std::size_t r = 0; r < n_elite && r < order.size(); ++r) {
+      if (!std::isfinite(scored[order[r]].score)) break;
+      for (std::size_t j = 0; j < kNumParams; ++j) m[j] += unit[order[r]][j];
+      ++n;
+    }
+    if (n > 0) {
+      for (std::size_t j = 0; j < kNumParams; ++j) m[j] /= static_cast<double>(n);
+      for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t j = 0; j < kNumParams; ++j) {
+          const double d = unit[order[r]][j] - m[j];
+          s2[j] += d * d / static_cast<double>(n);
+        }
+      }
+      for (std::size_t j = 0; j < kNumParams; ++j) {
+        mean[j] = opt.smoothing * m[j] + (1.0 - opt.smoothing) * mean[j];
+        sigma[j] = std::max(
+            0.02, opt.smoothing * std::sqrt(s2[j]) + (1.0 - opt.smoothing) * sigma[j]);
+      }
+    }
+
+    for (std::size_t i = 0; i < opt.population; ++i) {
+      const FalsifyCase& c = scored[i];
+      if (!c.feasible || !std::isfinite(c.score)) continue;
+      // FALSE_AEB scores of runs without activation only steer the search
+      if (opt.objective == FalsifyObjective::FALSE_AEB && !(c.aeb_time_s > 0.0 && c.score < 0.0)) {
+        continue;
+      }
+      archive.emplace_back(unit[i], c);
+    }
+  }
+
+  std::stable_sort(archive.begin(), archive.end(),
+                   [](const auto& a, const auto& b) { return a.second.score < b.second.score; });
+
+  // worst first, skipping near-duplicates of cases already taken
+  std::vector<FalsifyCase> worst;
+  std::vector<ParamVec> taken;
+  for (const auto& [u, c] : archive) {
+    if (worst.size() >= opt.keep) break;
+    const bool dup = std::any_of(taken.begin(), taken.end(), [&](const ParamVec& t) {
+      for (std::size_t j = 0; j < kNumParams; ++j) {
+        if (std::abs(t[j] - u[j]) > 0.02) return false;
+      }
+      return true;
+    });
+    if (dup) continue;
+    taken.push_back(u);
+    worst.push_back(c);
+  }
+  return worst;
+}
+
+}  // namespace sim
@@ -0,0 +1,77 @@
+#include "sim/fast_forward.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+// Keep the proven bounds this far inside the real limits to absorb rounding.
+static constexpr double kMargin = 0.5;
+
+// Upper bound on the ticks needed for ||A^k|| to drop below 1 (otherwise: not contractive).
+static constexpr std::size_t kMaxSettleTicks = 1000000;
+
+CruiseFastForward::Mat2 CruiseFastForward::mul(const Mat2& x, const Mat2& y) {
+  return Mat2{x.a * y.a + x.b * y.c, x.a * y.b + x.b * y.d,
+              x.c * y.a + x.d * y.c, x.c * y.b + x.d * y.d};
+}
+
+double CruiseFastForward::norm_inf(const Mat2& m) {
+  return std::max(std::abs(m.a) + std::abs(m.b), std::abs(m.c) + std::abs(m.d));
+}
+
+CruiseFastForward::CruiseFastForward(const acc::Config& cfg)
+    : Ts_(cfg.Ts_s), kp_(cfg.cruise_kp), ki_(cfg.cruise_ki) {
+  const double Ts = Ts_;
+  const double kp = kp_;
+  const double ki = ki_;
+
+  // I[k+1] = I + ki*Ts*e
+  // a[k]   = kp*e + I[k+1] = (kp + ki*Ts)*e + I
+  // e[k+1] = e - Ts*a[k]
+  c_e_ = kp + ki * Ts;
+  c_i_ = 1.0;
+  A_ = Mat2{1.0 - Ts * c_e_, -Ts, ki * Ts, 1.0};
+
+  // a[k] - a[k-1] = c^T (A - I) x[k-1]
+  gain_da_ = std::abs(c_e_ * (A_.a - 1.0) + c_i_ * A_.c) +
+             std::abs(c_e_ * A_.b + c_i_ * (A_.d - 1.0));
+
+  // Once ||A^K|| < 1, every later power is bounded by one of A^0..A^K.
+  Mat2 p{1.0, 0.0, 0.0, 1.0};
+  for (std::size_t k = 1; k <= kMaxSettleTicks; ++k) {
+    p = mul(A_, p);
+    const double n = norm_inf(p);
+    if (!std::isfinite(n)) break;
+    sup_pow_ = std::max(sup_pow_, n);
+    if (n < 1.0) {
+      available_ = Ts > 0.0;
+      break;
+    }
+  }
+
+  max_da_ = kMargin * cfg.jerk_max_mps3 * Ts;
+  max_a_ = kMargin * std::min(cfg.a_max_mps2, -cfg.a_min_mps2);
+  max_i_ = kMargin * std::min(cfg.cruise_i_max, -cfg.cruise_i_min);
+}
+
+bool CruiseFastForward::stays_linear(double e_v, double cruise_i, double a_prev,
+                                     double v_set) const {
+  if (!available_) return false;
+
+  // first tick: the limiter compares against the last exact a_cmd
+  const double a0 = c_e_ * e_v + c_i_ * cruise_i;
+  if (std::abs(a0 - a_prev) > max_da_) return false;
+
+  // every later state satisfies ||x[k]|| <= sup_pow * ||x[0]||
+  const double bound = state_bound(e_v, cruise_i);
+  return gain_da_ * bound <= max_da_ &&
+         (std::abs(c_e_) + std::abs(c_i_)) * bound <= max_a_ &&
+         bound <= max_i_ &&
+         bound < kMargin * v_set;  // ego speed stays positive (no plant clamp, plausible)
+}
+
+double CruiseFastForward::state_bound(double e_v, double cruise_i) const {
+  return sup_pow_ * std::max(std::abs(e_v), std::abs(cruise_i));
+}
+
+}  // namespace sim
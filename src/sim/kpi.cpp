@@ -0,0 +1,103 @@
+#include "sim/kpi.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+namespace sim {
+
+KpiAccumulator::KpiAccumulator(const acc::Config& cfg, double t_end_s)
+    : Ts_(cfg.Ts_s),
+      ttc_warn_(cfg.ttc_warn_s),
+      time_gap_(cfg.time_gap_s),
+      d0_(cfg.standstill_offset_m),
+      t_end_(t_end_s) {
+  const double inf = std::numeric_limits<double>::infinity();
+  k_.min_distance_m = inf;
+  k_.min_ttc_s = inf;
+  k_.a_cmd_min_mps2 = inf;
+  k_.a_cmd_max_mps2 = -inf;
+}
+
+void KpiAccumulator::add(const Sample& s) {
+  const double t = s.in.t_s;
+  const acc::Mode mode = s.out.mode;
+  const double d = s.lead_distance_m;
+  const double ttc = s.out.ttc_s;
+  const double a = s.out.a_cmd_mps2;
+  const double v = s.ego_speed_mps;
+  const auto n = static_cast<double>(s.ticks);  // > 1 on fast-forward summary rows
+
+  k_.a_cmd_min_mps2 = std::min(k_.a_cmd_min_mps2, a);
+  k_.a_cmd_max_mps2 = std::max(k_.a_cmd_max_mps2, a);
+
+  if (s.in.lead_valid && std::isfinite(d)) k_.min_distance_m = std::min(k_.min_distance_m, d);
+  if (std::isfinite(ttc)) k_.min_ttc_s = std::min(k_.min_ttc_s, ttc);
+  if (mode == acc::Mode::AEB) k_.aeb_time_s += Ts_ * n;
+
+  // Jerk (exclude AEB and boundary); a summary row gives the mean over its ticks
+  if (has_prev_ && mode != acc::Mode::AEB && prev_mode_ != acc::Mode::AEB) {
+    const double jerk = std::abs(a - prev_a_) / (Ts_ * n);
+    k_.jerk_samples += s.ticks;
+    k_.max_jerk_total_mps3 = std::max(k_.max_jerk_total_mps3, jerk);
+    if (std::isfinite(ttc) && ttc < ttc_warn_) {
+      k_.max_jerk_emergency_mps3 = std::max(k_.max_jerk_emergency_mps3, jerk);
+    } else {
+      k_.max_jerk_comfort_mps3 = std::max(k_.max_jerk_comfort_mps3, jerk);
+    }
+  }
+
+  // Steady-state speed error for CRUISE (last 2 seconds)
+  if (mode == acc::Mode::CRUISE && t >= t_end_ - 2.0 && std::isfinite(s.in.v_set_mps)) {
+    cruise_err_sum_ += n * std::abs(s.in.v_set_mps - v);
+    cruise_err_n_ += n;
+  }
+
+  // Steady-state time-gap error for FOLLOW (last 5 seconds)
+  if (mode == acc::Mode::FOLLOW && s.in.lead_valid && t >= t_end_ - 5.0 && v > 0.5 &&
+      std::isfinite(d)) {
+    tgap_err_sum_ += n * std::abs((d - d0_) / v - time_gap_);
+    tgap_err_n_ += n;
+  }
+
+  has_prev_ = true;
+  prev_a_ = a;
+  prev_mode_ = mode;
+}
+
+Kpis KpiAccumulator::result() const {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  Kpis k = k_;
+  k.cruise_ss_speed_err_mps = cruise_err_n_ > 0.0 ? cruise_err_sum_ / cruise_err_n_ : nan;
+  k.follow_ss_tgap_err_s = tgap_err_n_ > 0.0 ? tgap_err_sum_ / tgap_err_n_ : nan;
+  return k;
+}
+
+static std::string fmt3(double x) {
+  if (std::isnan(x)) return "nan";
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%.3f", x);
+  return buf;
+}
+
+void write_kpi_report(std::ostream& os, const Kpis& k, double ttc_warn_s) {
+  const std::string warn = fmt3(ttc_warn_s);
+  os << "min_distance_m:          " << fmt3(k.min_distance_m) << "\n"
+     << "min_ttc_s:               " << fmt3(k.min_ttc_s) << "\n"
+     << "aeb_time_s:              " << fmt3(k.aeb_time_s) << "\n"
+     << "a_cmd_range_mps2:         [" << fmt3(k.a_cmd_min_mps2) << ", " << fmt3(k.a_cmd_max_mps2)
+     << "]\n"
+     << "jerk_samples_excl_aeb:    " << k.jerk_samples << "\n"
+     << "max_jerk_total_mps3:      " << fmt3(k.max_jerk_total_mps3) << " (excluding AEB)\n"
+     << "max_jerk_comfort_mps3:    " << fmt3(k.max_jerk_comfort_mps3) << " (ttc >= " << warn
+     << ")\n"
+     << "max_jerk_emergency_mps3:  " << fmt3(k.max_jerk_emergency_mps3) << " (ttc < " << warn
+     << ")\n"
+     << "cruise_ss_speed_err_mps:  " << fmt3(k.cruise_ss_speed_err_mps)
+     << " (mean |v_set-v| last 2s in CRUISE)\n"
+     << "follow_ss_tgap_err_s:     " << fmt3(k.follow_ss_tgap_err_s)
+     << " (mean |tgap-T| last 5s in FOLLOW)\n";
+}
+
+}  // namespace sim
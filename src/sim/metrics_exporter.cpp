@@ -0,0 +1,213 @@
+#include "sim/metrics_exporter.hpp"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "sim/parse_number.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace sim {
+
+static const char* const kModeNames[acc::kNumModes] = {"OFF", "CRUISE", "FOLLOW", "AEB", "FAULT"};
+
+static std::string prom_double(double x) {
+  if (std::isnan(x)) return "NaN";
+  if (std::isinf(x)) return x > 0.0 ? "+Inf" : "-Inf";
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%.9g", x);
+  return buf;
+}
+
+static void header(std::ostream& os, const char* name, const char* type, const char* help) {
+  os << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+
+std::string to_prometheus(const acc::MetricsSnapshot& m) {
+  std::ostringstream os;
+
+  header(os, "acc_steps_total", "counter", "Function::step calls.");
+  os << "acc_steps_total " << m.steps << "\n";
+
+  header(os, "acc_mode_ticks_total", "counter", "Controller ticks per FSM mode.");
+  for (std::size_t i = 0; i < acc::kNumModes; ++i) {
+    os << "acc_mode_ticks_total{mode=\"" << kModeNames[i] << "\"} " << m.mode_ticks[i] << "\n";
+  }
+
+  header(os, "acc_aeb_activations_total", "counter", "Transitions into AEB.");
+  os << "acc_aeb_activations_total " << m.aeb_activations << "\n";
+
+  header(os, "acc_ttc_min_seconds", "gauge", "Smallest finite TTC seen.");
+  os << "acc_ttc_min_seconds " << prom_double(m.ttc_min_s) << "\n";
+
+  header(os, "acc_jerk_peak_mps3", "gauge", "Peak |jerk| of a_cmd outside AEB.");
+  os << "acc_jerk_peak_mps3 " << prom_double(m.jerk_peak_mps3) << "\n";
+
+  header(os, "acc_step_latency_seconds", "histogram", "Sampled Function::step latency.");
+  std::uint64_t cum = 0;
+  for (std::size_t i = 0; i < acc::MetricsSnapshot::kLatencyBuckets; ++i) {
+    cum += m.latency_buckets[i];
+    const std::string le = (i < acc::MetricsSnapshot::kLatencyBoundsNs.size())
+                               ? prom_double(acc::MetricsSnapshot::kLatencyBoundsNs[i] * 1e-9)
+                               : "+Inf";
+    os << "acc_step_latency_seconds_bucket{le=\"" << le << "\"} " << cum << "\n";
+  }
+  os << "acc_step_latency_seconds_sum " << prom_double(m.latency_sum_ns * 1e-9) << "\n";
+  os << "acc_step_latency_seconds_count " << m.latency_count << "\n";
+
+  header(os, "acc_step_latency_max_seconds", "gauge", "Largest sampled Function::step latency.");
+  os << "acc_step_latency_max_seconds " << prom_double(m.latency_max_ns * 1e-9) << "\n";
+
+  return os.str();
+}
+
+void MetricsExporter::write_file() const {
+  if (opt_.file_path.empty()) return;
+  const std::string tmp = opt_.file_path + ".tmp";
+  {
+    std::ofstream f(tmp);
+    if (!f) return;
+    f << to_prometheus(metrics_.snapshot());
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp, opt_.file_path, ec);
+}
+
+#ifndef _WIN32
+
+bool MetricsExporter::start(const ExporterOptions& opt) {
+  stop();
+  opt_ = opt;
+  stop_ = false;
+
+  if (opt_.http_port >= 0) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+    const int yes = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<std::uint16_t>(opt_.http_port));
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+        ::listen(listen_fd_, 8) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+      ::close(listen_fd_);
+      listen_fd_ = -1;
+      return false;
+    }
+    port_ = ntohs(addr.sin_port);
+  }
+
+  thread_ = std::thread(&MetricsExporter::run, this);
+  return true;
+}
+
+void MetricsExporter::stop() {
+  if (!thread_.joinable()) return;
+  stop_ = true;
+  thread_.join();
+  if (listen_fd_ >= 0) ::close(listen_fd_);
+  listen_fd_ = -1;
+  port_ = -1;
+  write_file();
+}
+
+void MetricsExporter::run() {
+  using clock = std::chrono::steady_clock;
+  auto next_file = clock::now();
+
+  while (!stop_) {
+    if (!opt_.file_path.empty() && clock::now() >= next_file) {
+      write_file();
+      next_file += opt_.period;
+    }
+
+    // wake up at least every 50 ms to notice stop()
+    if (listen_fd_ < 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      continue;
+    }
+    pollfd p{listen_fd_, POLLIN, 0};
+    if (::poll(&p, 1, 50) <= 0) continue;
+
+    const int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) continue;
+
+    // every request gets the metrics page; the request itself is drained but not parsed
+    char buf[1024];
+    pollfd c{fd, POLLIN, 0};
+    if (::poll(&c, 1, 200) > 0) (void)::recv(fd, buf, sizeof(buf), 0);
+
+    const std::string body = to_prometheus(metrics_.snapshot());
+    const std::string resp = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                             "Content-Length: " +
+                             std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    std::size_t sent = 0;
+    while (sent < resp.size()) {
+      const auto n = ::send(fd, resp.data() + sent, resp.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0) break;
+      sent += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+  }
+}
+
+#else  // _WIN32: file snapshots only
+
+bool MetricsExporter::start(const ExporterOptions& opt) {
+  stop();
+  opt_ = opt;
+  stop_ = false;
+  if (opt_.http_port >= 0) return false;
+  thread_ = std::thread(&MetricsExporter::run, this);
+  return true;
+}
+
+void MetricsExporter::stop() {
+  if (!thread_.joinable()) return;
+  stop_ = true;
+  thread_.join();
+  write_file();
+}
+
+void MetricsExporter::run() {
+  using clock = std::chrono::steady_clock;
+  auto next_file = clock::now();
+  while (!stop_) {
+    if (!opt_.file_path.empty() && clock::now() >= next_file) {
+      write_file();
+      next_file += opt_.period;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+}
+
+#endif
+
+// The whole value must parse and lie in [lo, hi] ("80x" is rejected, not read as 80).
+bool start_exporter(MetricsExporter& exporter, const std::string& file_path,
+                    const std::string& port, const std::string& period_ms) {
+  ExporterOptions eo;
+  eo.file_path = file_path;
+  eo.http_port = parse_number("--metrics-port", port, -1, 65535);
+  eo.period =
+      std::chrono::milliseconds(parse_number("--metrics-period-ms", period_ms, 1, 86400000));
+  if (eo.file_path.empty() && eo.http_port < 0) return false;
+  if (!exporter.start(eo)) {
+    throw std::runtime_error("Cannot serve metrics on port " + std::to_string(eo.http_port));
+  }
+  return true;
+}
+
+}  // namespace sim
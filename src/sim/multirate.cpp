@@ -0,0 +1,178 @@
+#include "sim/multirate.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "acc/function.hpp"
+
+namespace sim {
+
+namespace {
+
+// Order of events at the same instant: measure, deliver, control, then integrate [t, t+dt).
+enum class EventKind : std::uint8_t { SENSOR = 0, DELIVER = 1, CONTROLLER = 2, PLANT = 3 };
+
+struct Measurement {
+  bool lead_valid{false};
+  double lead_distance_m{std::numeric_limits<double>::infinity()};
+  double lead_rel_speed_mps{0.0};
+};
+
+struct Event {
+  std::int64_t t_us{0};
+  EventKind kind{EventKind::PLANT};
+  std::uint64_t seq{0};  // FIFO among equal (t, kind), e.g. queued deliveries
+  Measurement m{};
+};
+
+struct Later {
+  bool operator()(const Event& a, const Event& b) const {
+    if (a.t_us != b.t_us) return a.t_us > b.t_us;
+    if (a.kind != b.kind) return a.kind > b.kind;
+    return a.seq > b.seq;
+  }
+};
+
+}  // namespace
+
+static std::int64_t to_us(double s) { return std::llround(s * 1e6); }
+
+// Division, not * 1e-6: 100000 us must give the double 0.1, the value the Ts grid uses.
+static double to_s(std::int64_t us) { return static_cast<double>(us) / 1e6; }
+
+// Index of the scenario row in effect at t (the left end of its interval, as in sample()).
+static std::size_t row_index(const Scenario& sc, double t) {
+  const auto it = std::upper_bound(sc.rows.begin(), sc.rows.end(), t,
+                                   [](double val, const Row& r) { return val < r.t_s; });
+  return it == sc.rows.begin() ? 0 : static_cast<std::size_t>(it - sc.rows.begin()) - 1;
+}
+
+MultiRateStats run_multirate(const Scenario& sc, const acc::Config& cfg_in,
+                             const MultiRateOptions& opt, const SampleSink& sink) {
+  const std::int64_t plant_us = to_us(opt.plant_dt_s);
+  const std::int64_t ctrl_us = to_us(opt.controller_dt_s);
+  const std::int64_t sensor_us = to_us(opt.sensor_dt_s);
+  const std::int64_t latency_us = to_us(opt.sensor_latency_s);
+  if (plant_us <= 0 || ctrl_us <= 0 || sensor_us <= 0 || latency_us < 0) {
+    throw std::invalid_argument("multirate: periods must be >= 1 us and latency >= 0");
+  }
+  const std::int64_t end_us = to_us(sc.duration_s());
+  // the row of the last controller step is logged once the plant reached the next tick
+  const std::int64_t horizon_us = end_us + ctrl_us;
+
+  acc::Config cfg = cfg_in;
+  cfg.Ts_s = to_s(ctrl_us);
+  acc::Function fn(cfg);
+  fn.attach_metrics(opt.metrics);
+
+  // True plant state; the lead gap is tracked while the sensor does not see it.
+  double v_ego = sc.meta.init_ego_speed_mps;
+  double d = sc.meta.init_lead_distance_m;
+  double a_cmd = 0.0;  // zero-order hold between controller steps
+  Measurement held{};  // sample-and-hold of the last delivered measurement
+
+  // An override row resets the gap once, on the first plant step at which it is in effect.
+  std::size_t override_row = sc.rows.size();
+  auto apply_override = [&](double t) {
+    if (sc.rows.empty()) return;
+    const std::size_t i = row_index(sc, t);
+    if (i == override_row || !sc.rows[i].has_distance_override) return;
+    d = sc.rows[i].lead_distance_m_override;
+    override_row = i;
+  };
+  apply_override(0.0);
+
+  // Like run_closed_loop, a controller step's row carries the plant state after that step, so
+  // it is completed at the next controller tick.
+  Sample pending{};
+  bool has_pending = false;
+
+  std::priority_queue<Event, std::vector<Event>, Later> q;
+  std::uint64_t seq = 0;
+  auto push = [&](std::int64_t t, EventKind k, const Measurement& m = Measurement{}) {
+    if (t <= horizon_us) q.push(Event{t, k, seq++, m});
+  };
+  push(0, EventKind::SENSOR);
+  push(0, EventKind::CONTROLLER);
+  push(0, EventKind::PLANT);
+
+  MultiRateStats stats{};
+  while (!q.empty()) {
+    const Event e = q.top();
+    q.pop();
+    const double t = to_s(e.t_us);
+
+    switch (e.kind) {
+      case EventKind::SENSOR: {
+        const Row row = sc.sample(t);
+        Measurement m{};
+        m.lead_valid = row.lead_valid;
+        if (row.lead_valid) {
+          m.lead_distance_m = d;
+          m.lead_rel_speed_mps = row.v_lead_mps - v_ego;
+        }
+        ++stats.sensor_samples;
+        push(e.t_us + latency_us, EventKind::DELIVER, m);
+        push(e.t_us + sensor_us, EventKind::SENSOR);
+        break;
+      }
+
+      case EventKind::DELIVER:
+        held = e.m;
+        break;
+
+      case EventKind::CONTROLLER: {
+        if (has_pending) {
+          pending.ego_speed_mps = v_ego;
+          pending.lead_distance_m = held.lead_distance_m;  // sensor view, like lead_valid
+          pending.lead_gap_m = d;
+          sink(pending);
+          has_pending = false;
+        }
+        if (e.t_us > end_us) break;
+
+        const Row row = sc.sample(t);
+        Sample s{};
+        s.in.t_s = t;
+        s.in.acc_enable = true;
+        s.in.aeb_enable = opt.aeb_enable;
+        s.in.ego_speed_mps = v_ego;
+        s.in.v_set_mps = row.v_set_mps;
+        s.in.lead_valid = held.lead_valid;
+        s.in.lead_distance_m = held.lead_distance_m;
+        s.in.lead_rel_speed_mps = held.lead_rel_speed_mps;
+
+        s.out = fn.step(s.in);
+        a_cmd = s.out.a_cmd_mps2;
+        ++stats.controller_steps;
+
+        pending = s;
+        has_pending = true;
+        push(e.t_us + ctrl_us, EventKind::CONTROLLER);
+        break;
+      }
+
+      case EventKind::PLANT: {
+        // same discretisation as run_closed_loop: v first, then the gap with the new v
+        const double dt = to_s(plant_us);
+        const double v_lead = sc.sample(t).v_lead_mps;
+        v_ego = std::max(0.0, v_ego + a_cmd * dt);
+        if (std::isfinite(d)) d = std::max(0.0, d + (v_lead - v_ego) * dt);
+        ++stats.plant_steps;
+
+        const std::int64_t next = e.t_us + plant_us;
+        apply_override(to_s(next));
+        if (next < horizon_us) push(next, EventKind::PLANT);
+        break;
+      }
+    }
+  }
+
+  return stats;
+}
+
+}  // namespace sim
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -58,6 +59,26 @@ Row Scenario::sample(double t) const {
   return r;
 }
 
+static bool same_inputs(const Row& a, const Row& b) {
+  return a.lead_valid == b.lead_valid && a.v_set_mps == b.v_set_mps &&
+         a.v_lead_mps == b.v_lead_mps && !a.has_distance_override && !b.has_distance_override;
+}
+
+double Scenario::steady_until(double t) const {
+  if (rows.empty() || t >= rows.back().t_s) return std::numeric_limits<double>::infinity();
+  if (t < rows.front().t_s) return rows.front().t_s;
+
+  // row i is the left end of the interval containing t
+  auto it = std::upper_bound(rows.begin(), rows.end(), t,
+                             [](double val, const Row& r) { return val < r.t_s; });
+  size_t i = static_cast<size_t>(std::distance(rows.begin(), it)) - 1;
+
+  size_t j = i;
+  while (j + 1 < rows.size() && same_inputs(rows[i], rows[j + 1])) ++j;
+  if (j + 1 == rows.size()) return std::numeric_limits<double>::infinity();
+  return std::max(t, rows[j].t_s);
+}
+
 Scenario load_csv(const std::string& path) {
   std::ifstream f(path);
   if (!f) throw std::runtime_error("Cannot open scenario: " + path);
@@ -138,4 +159,24 @@ Scenario load_csv(const std::string& path) {
   return sc;
 }
 
+void save_csv(const std::string& path, const Scenario& sc,
+              const std::vector<std::pair<std::string, double>>& extra_meta) {
+  std::ofstream f(path);
+  if (!f) throw std::runtime_error("Cannot write scenario: " + path);
+  f.precision(17);  // row times must replay on the same loop ticks
+
+  f << "# Ts_s=" << sc.meta.Ts_s << "\n"
+    << "# init_ego_speed_mps=" << sc.meta.init_ego_speed_mps << "\n"
+    << "# init_lead_distance_m=" << sc.meta.init_lead_distance_m << "\n";
+  for (const auto& [key, val] : extra_meta) f << "# " << key << "=" << val << "\n";
+
+  f << "t_s,lead_valid,v_lead_mps,v_set_mps,lead_distance_m\n";
+  for (const auto& r : sc.rows) {
+    f << r.t_s << "," << (r.lead_valid ? 1 : 0) << "," << r.v_lead_mps << "," << r.v_set_mps << ",";
+    if (r.has_distance_override) f << r.lead_distance_m_override;
+    f << "\n";
+  }
+  if (!f) throw std::runtime_error("Cannot write scenario: " + path);
+}
+
 }  // namespace sim
\ No newline at end of file
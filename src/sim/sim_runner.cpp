@@ -2,12 +2,16 @@
 #include <fstream>
 #include <filesystem>
 #include <iostream>
-#include <limits>
+#include <stdexcept>
 #include <string>
 
-#include "acc/function.hpp"
-#include "acc/types.hpp"
+#include "acc/metrics.hpp"
+#include "sim/closed_loop.hpp"
+#include "sim/metrics_exporter.hpp"
+#include "sim/multirate.hpp"
+#include "sim/parse_number.hpp"
 #include "sim/scenario.hpp"
+#include "sim/trace_csv.hpp"
 
 static std::string get_arg(int argc, char** argv, const std::string& key, const std::string& def) {
   for (int i = 1; i + 1 < argc; ++i) {
@@ -21,12 +25,43 @@ static bool has_flag(int argc, char** argv, const std::string& key) {
   return false;
 }
 
-static int mode_to_int(acc::Mode m) { return static_cast<int>(m); }
-
 int main(int argc, char** argv) {
   const std::string scenario_path = get_arg(argc, argv, "--scenario", "scenarios/lead_brake.csv");
   const std::string out_path      = get_arg(argc, argv, "--out", "results/out.csv");
   const bool aeb_off              = has_flag(argc, argv, "--no-aeb");
+  const bool fast_forward         = has_flag(argc, argv, "--fast-forward");
+
+  // multi-rate mode: any of these switches it on (controller runs at the scenario Ts_s)
+  double plant_hz = 0.0;
+  double sensor_hz = 0.0;
+  double sensor_latency_ms = 0.0;
+  try {
+    plant_hz = sim::parse_number("--plant-hz", get_arg(argc, argv, "--plant-hz", "0"), 0.0);
+    sensor_hz = sim::parse_number("--sensor-hz", get_arg(argc, argv, "--sensor-hz", "0"), 0.0);
+    sensor_latency_ms = sim::parse_number(
+        "--sensor-latency-ms", get_arg(argc, argv, "--sensor-latency-ms", "0"), 0.0);
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+  const bool multirate = plant_hz > 0.0 || sensor_hz > 0.0 || sensor_latency_ms > 0.0;
+  if (multirate && fast_forward) {
+    std::cerr << "--fast-forward cannot be combined with --plant-hz/--sensor-hz/"
+                 "--sensor-latency-ms\n";
+    return 1;
+  }
+
+  sim::TraceFormat trace_fmt;
+  try {
+    trace_fmt = sim::parse_trace_format(get_arg(argc, argv, "--columns", ""),
+                                        get_arg(argc, argv, "--precision", "6"),
+                                        get_arg(argc, argv, "--every", "1"));
+  } catch (const std::exception& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  }
+
+  if (fast_forward) sim::add_ticks_column(trace_fmt);
 
   sim::Scenario sc;
   try {
@@ -39,11 +74,28 @@ int main(int argc, char** argv) {
   acc::Config cfg;
   cfg.Ts_s = sc.meta.Ts_s;
 
-  acc::Function fn(cfg);
+  sim::RunOptions opt;
+  opt.aeb_enable = !aeb_off;
+  opt.fast_forward = fast_forward;
 
-  // Closed-loop "plant"
-  double v_ego = sc.meta.init_ego_speed_mps;
-  double d = sc.meta.init_lead_distance_m;
+  acc::Metrics metrics;
+  sim::MetricsExporter exporter(metrics);
+  try {
+    if (sim::start_exporter(exporter, get_arg(argc, argv, "--metrics-file", ""),
+                            get_arg(argc, argv, "--metrics-port", "-1"),
+                            get_arg(argc, argv, "--metrics-period-ms", "1000"))) {
+      opt.metrics = &metrics;
+    }
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid argument: " << e.what() << "\n";
+    return 1;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  if (exporter.http_port() >= 0) {
+    std::cout << "Metrics: http://127.0.0.1:" << exporter.http_port() << "/metrics\n";
+  }
 
   {
     const std::filesystem::path p(out_path);
@@ -59,54 +111,36 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  out << "t_s,mode,ego_speed_mps,v_set_mps,lead_valid,lead_distance_m,lead_rel_speed_mps,"
-       "a_cmd_mps2,ttc_s,d_des_m,distance_error_m,a_cruise_mps2,a_follow_mps2\n";
-
-  const double t_end = sc.duration_s();
-  for (double t = 0.0; t <= t_end + 1e-9; t += cfg.Ts_s) {
-    const auto row = sc.sample(t);
-
-    // Lead state from scenario
-    const bool lead_valid = row.lead_valid;
-    const double v_lead = row.v_lead_mps;
-
-    if (row.has_distance_override) d = row.lead_distance_m_override;
-    if (!lead_valid) d = std::numeric_limits<double>::infinity();
-
-    // Compute relative speed (v_lead - v_ego)
-    const double v_rel = lead_valid ? (v_lead - v_ego) : 0.0;
-
-    // Build function input
-    acc::Input in;
-    in.v_set_mps = row.v_set_mps;
-    in.t_s = t;
-    in.acc_enable = true;
-    in.aeb_enable = !aeb_off;
-    in.driver_brake = false;
-    in.driver_throttle = false;
-    in.ego_speed_mps = v_ego;
-    in.lead_valid = lead_valid;
-    in.lead_distance_m = d;
-    in.lead_rel_speed_mps = v_rel;
-
-    // Run function
-    const auto y = fn.step(in);
-
-    // Plant update (very simple)
-    // v_ego[k+1] = max(0, v_ego + a_cmd*Ts)
-    v_ego = std::max(0.0, v_ego + y.a_cmd_mps2 * cfg.Ts_s);
-
-    // d[k+1] = d + (v_lead - v_ego)*Ts  (only if lead exists)
-    if (lead_valid && std::isfinite(d)) {
-      d = std::max(0.0, d + (v_lead - v_ego) * cfg.Ts_s);
+  sim::TraceWriter trace(out, trace_fmt);
+  const auto write_row = [&](const sim::Sample& s) { trace.add(s); };
+
+  if (multirate) {
+    sim::MultiRateOptions mr;
+    mr.controller_dt_s = cfg.Ts_s;
+    mr.plant_dt_s = plant_hz > 0.0 ? 1.0 / plant_hz : cfg.Ts_s;
+    mr.sensor_dt_s = sensor_hz > 0.0 ? 1.0 / sensor_hz : cfg.Ts_s;
+    mr.sensor_latency_s = sensor_latency_ms * 1e-3;
+    mr.aeb_enable = opt.aeb_enable;
+    mr.metrics = opt.metrics;
+
+    sim::MultiRateStats stats;
+    try {
+      stats = sim::run_multirate(sc, cfg, mr, write_row);
+    } catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << "\n";
+      return 1;
+    }
+    std::cout << "Multi-rate: " << stats.plant_steps << " plant, " << stats.controller_steps
+              << " controller, " << stats.sensor_samples << " sensor events\n";
+  } else {
+    const auto stats = sim::run_closed_loop(sc, cfg, opt, write_row);
+    if (fast_forward) {
+      std::cout << "Fast-forward: " << stats.steps << " of " << stats.ticks
+                << " ticks stepped exactly, " << stats.samples << " rows\n";
     }
-
-    out << t << "," << mode_to_int(y.mode) << "," << v_ego << "," << in.v_set_mps << ","
-    << (lead_valid ? 1 : 0) << "," << d << "," << v_rel << ","
-    << y.a_cmd_mps2 << "," << y.ttc_s << ","
-    << y.d_des_m << "," << y.distance_error_m << ","
-    << y.a_cruise_mps2 << "," << y.a_follow_mps2 << "\n";
   }
+  exporter.stop();
+  trace.flush();
 
   std::cout << "Wrote: " << out_path << "\n";
   return 0;
@@ -0,0 +1,150 @@
+#include "sim/trace_csv.hpp"
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "sim/parse_number.hpp"
+
+namespace sim {
+
+static const char* const kColumnNames[kNumTraceColumns] = {
+    "t_s",        "mode",  "ego_speed_mps",    "v_set_mps",     "lead_valid",
+    "lead_distance_m", "lead_rel_speed_mps",  "a_cmd_mps2",  "ttc_s",  "d_des_m",
+    "distance_error_m", "a_cruise_mps2", "a_follow_mps2", "ticks"};
+
+// "-" + 17 digits + "." + "e-308" stays below this at any precision the formatter accepts
+static constexpr std::size_t kMaxNumberBytes = 32;
+static constexpr int kMaxPrecision = 17;
+
+const char* trace_column_name(TraceColumn c) { return kColumnNames[static_cast<std::size_t>(c)]; }
+
+static std::string trim(const std::string& s) {
+  const auto b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos) return "";
+  const auto e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+
+std::vector<TraceColumn> parse_trace_columns(const std::string& names) {
+  std::vector<TraceColumn> cols;
+  std::size_t pos = 0;
+  while (pos <= names.size()) {
+    const std::size_t end = std::min(names.find(',', pos), names.size());
+    const std::string name = trim(names.substr(pos, end - pos));
+    const auto it = std::find_if(std::begin(kColumnNames), std::end(kColumnNames),
+                                 [&](const char* n) { return name == n; });
+    if (it == std::end(kColumnNames)) {
+      throw std::invalid_argument("Unknown trace column: '" + name + "'");
+    }
+    cols.push_back(static_cast<TraceColumn>(it - std::begin(kColumnNames)));
+    pos = end + 1;
+  }
+  return cols;
+}
+
+// The whole value must parse and be >= lo ("10x" is rejected, not read as 10).
+TraceFormat parse_trace_format(const std::string& columns, const std::string& precision,
+                               const std::string& every) {
+  TraceFormat fmt;
+  if (!columns.empty()) fmt.columns = parse_trace_columns(columns);
+  fmt.precision = parse_number("--precision", precision, 0);
+  fmt.every_n = parse_number<std::size_t>("--every", every, 1);
+  return fmt;
+}
+
+static TraceFormat normalized(TraceFormat fmt) {
+  if (fmt.columns.empty()) {
+    for (std::size_t i = 0; i < kNumDefaultTraceColumns; ++i) {
+      fmt.columns.push_back(static_cast<TraceColumn>(i));
+    }
+  }
+  fmt.precision = std::clamp(fmt.precision, 0, kMaxPrecision);
+  fmt.every_n = std::max<std::size_t>(fmt.every_n, 1);
+  return fmt;
+}
+
+void add_ticks_column(TraceFormat& fmt) {
+  if (fmt.columns.empty()) fmt.columns = normalized(fmt).columns;
+  if (std::find(fmt.columns.begin(), fmt.columns.end(), TraceColumn::TICKS) == fmt.columns.end()) {
+    fmt.columns.push_back(TraceColumn::TICKS);
+  }
+}
+
+TraceFormatter::TraceFormatter(TraceFormat fmt)
+    : fmt_(normalized(std::move(fmt))),
+      max_row_bytes_(fmt_.columns.size() * (kMaxNumberBytes + 1)) {}
+
+std::string TraceFormatter::header() const {
+  std::string h;
+  for (std::size_t i = 0; i < fmt_.columns.size(); ++i) {
+    if (i > 0) h += ',';
+    h += trace_column_name(fmt_.columns[i]);
+  }
+  h += '\n';
+  return h;
+}
+
+static char* put(char* p, double x, int precision) {
+  const auto r = (precision > 0)
+                     ? std::to_chars(p, p + kMaxNumberBytes, x, std::chars_format::general,
+                                     precision)
+                     : std::to_chars(p, p + kMaxNumberBytes, x);
+  return r.ptr;
+}
+
+char* TraceFormatter::row(char* p, const Sample& s) const {
+  const auto& in = s.in;
+  const auto& y = s.out;
+  const int prec = fmt_.precision;
+  for (std::size_t i = 0; i < fmt_.columns.size(); ++i) {
+    if (i > 0) *p++ = ',';
+    switch (fmt_.columns[i]) {
+      case TraceColumn::T_S: p = put(p, in.t_s, prec); break;
+      case TraceColumn::MODE: *p++ = static_cast<char>('0' + static_cast<int>(y.mode)); break;
+      case TraceColumn::EGO_SPEED_MPS: p = put(p, s.ego_speed_mps, prec); break;
+      case TraceColumn::V_SET_MPS: p = put(p, in.v_set_mps, prec); break;
+      case TraceColumn::LEAD_VALID: *p++ = in.lead_valid ? '1' : '0'; break;
+      case TraceColumn::LEAD_DISTANCE_M: p = put(p, s.lead_distance_m, prec); break;
+      case TraceColumn::LEAD_REL_SPEED_MPS: p = put(p, in.lead_rel_speed_mps, prec); break;
+      case TraceColumn::A_CMD_MPS2: p = put(p, y.a_cmd_mps2, prec); break;
+      case TraceColumn::TTC_S: p = put(p, y.ttc_s, prec); break;
+      case TraceColumn::D_DES_M: p = put(p, y.d_des_m, prec); break;
+      case TraceColumn::DISTANCE_ERROR_M: p = put(p, y.distance_error_m, prec); break;
+      case TraceColumn::A_CRUISE_MPS2: p = put(p, y.a_cruise_mps2, prec); break;
+      case TraceColumn::A_FOLLOW_MPS2: p = put(p, y.a_follow_mps2, prec); break;
+      case TraceColumn::TICKS: p = std::to_chars(p, p + kMaxNumberBytes, s.ticks).ptr; break;
+    }
+  }
+  *p++ = '\n';
+  return p;
+}
+
+TraceWriter::TraceWriter(std::ostream& os, TraceFormat fmt, std::size_t buffer_bytes)
+    : os_(os), fmt_(std::move(fmt)) {
+  buf_.resize(std::max(buffer_bytes, 2 * fmt_.max_row_bytes()));
+  const std::string h = fmt_.header();
+  os_.write(h.data(), static_cast<std::streamsize>(h.size()));
+}
+
+void TraceWriter::add(const Sample& s) {
+  if (seen_++ % fmt_.format().every_n != 0) return;
+  if (buf_.size() - used_ < fmt_.max_row_bytes()) flush();
+  used_ = static_cast<std::size_t>(fmt_.row(buf_.data() + used_, s) - buf_.data());
+}
+
+void TraceWriter::flush() {
+  if (used_ == 0) return;
+  os_.write(buf_.data(), static_cast<std::streamsize>(used_));
+  used_ = 0;
+}
+
+void write_trace_header(std::ostream& os) { os << TraceFormatter().header(); }
+
+void write_trace_row(std::ostream& os, const Sample& s) {
+  static const TraceFormatter fmt;
+  char buf[kNumDefaultTraceColumns * (kMaxNumberBytes + 1)];
+  os.write(buf, fmt.row(buf, s) - buf);
+}
+
+}  // namespace sim
@@ -0,0 +1,248 @@
+#include "sim/trace_store.hpp"
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#endif
+
+namespace sim {
+
+namespace {
+
+struct Piece {
+  const char* data;
+  std::size_t size;
+};
+
+}  // namespace
+
+static constexpr std::size_t kMaxBatchRuns = 64;
+
+#ifndef _WIN32
+
+static int open_out(const std::string& path) {
+  return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+static void close_out(int fd) { ::close(fd); }
+
+static constexpr std::size_t kMaxIov = IOV_MAX;
+
+// writev in IOV_MAX slices, resuming after short writes.
+static bool write_all(int fd, const std::vector<Piece>& pieces) {
+  std::vector<iovec> iov;
+  std::size_t i = 0;
+  std::size_t skip = 0;  // bytes of pieces[i] already written
+  while (i < pieces.size()) {
+    iov.clear();
+    for (std::size_t j = i; j < pieces.size() && iov.size() < kMaxIov; ++j) {
+      const std::size_t off = (j == i) ? skip : 0;
+      iov.push_back({const_cast<char*>(pieces[j].data) + off, pieces[j].size - off});
+    }
+    const ssize_t n = ::writev(fd, iov.data(), static_cast<int>(iov.size()));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+
+    auto left = static_cast<std::size_t>(n);
+    while (i < pieces.size() && left >= pieces[i].size - skip) {
+      left -= pieces[i].size - skip;
+      skip = 0;
+      ++i;
+    }
+    skip += left;
+  }
+  return true;
+}
+
+#else  // _WIN32: no writev, one _write per block
+
+static int open_out(const std::string& path) {
+  return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+static void close_out(int fd) { ::_close(fd); }
+
+static bool write_all(int fd, const std::vector<Piece>& pieces) {
+  for (const auto& p : pieces) {
+    std::size_t done = 0;
+    while (done < p.size) {
+      const int n = ::_write(fd, p.data + done, static_cast<unsigned>(p.size - done));
+      if (n <= 0) return false;
+      done += static_cast<std::size_t>(n);
+    }
+  }
+  return true;
+}
+
+#endif
+
+static void append_pieces(const ArenaRun& run, std::vector<Piece>& pieces) {
+  for (const auto& b : run.blocks) pieces.push_back({b.data.get(), b.size});
+}
+
+ArenaBlock BlockPool::acquire() {
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    if (!free_.empty()) {
+      ArenaBlock b{std::move(free_.back()), 0};
+      free_.pop_back();
+      return b;
+    }
+  }
+  return ArenaBlock{std::unique_ptr<char[]>(new char[block_bytes_]), 0};
+}
+
+void BlockPool::release(std::vector<ArenaBlock>& blocks) {
+  std::lock_guard<std::mutex> lk(m_);
+  for (auto& b : blocks) {
+    if (b.data) free_.push_back(std::move(b.data));
+  }
+  blocks.clear();
+}
+
+TraceArena::TraceArena(BlockPool& pool, TraceFormat fmt)
+    : pool_(pool), os_(this), fmt_(std::move(fmt)) {
+  if (pool_.block_bytes() < fmt_.max_row_bytes()) scratch_.resize(fmt_.max_row_bytes());
+}
+
+TraceArena::~TraceArena() {
+  if (cur_.data) run_.blocks.push_back(std::move(cur_));
+  pool_.release(run_.blocks);
+}
+
+void TraceArena::begin_run() {
+  seen_ = 0;
+  os_ << fmt_.header();
+}
+
+void TraceArena::add(const Sample& s) {
+  if (seen_++ % fmt_.format().every_n != 0) return;
+  ++run_.rows;
+  if (!scratch_.empty()) {
+    os_.write(scratch_.data(), fmt_.row(scratch_.data(), s) - scratch_.data());
+    return;
+  }
+  if (static_cast<std::size_t>(epptr() - pptr()) < fmt_.max_row_bytes()) {
+    overflow(traits_type::eof());
+  }
+  pbump(static_cast<int>(fmt_.row(pptr(), s) - pptr()));
+}
+
+ArenaRun TraceArena::take() {
+  seal();
+  return std::exchange(run_, ArenaRun{});
+}
+
+void TraceArena::seal() {
+  const auto n = static_cast<std::size_t>(pptr() - pbase());
+  if (n == 0) return;  // cur_ (if any) is still empty and stays in use
+  cur_.size = n;
+  run_.bytes += n;
+  run_.blocks.push_back(std::move(cur_));
+  cur_ = ArenaBlock{};
+  setp(nullptr, nullptr);
+}
+
+TraceArena::int_type TraceArena::overflow(int_type c) {
+  seal();
+  if (!cur_.data) cur_ = pool_.acquire();
+  setp(cur_.data.get(), cur_.data.get() + pool_.block_bytes());
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+TraceStore::TraceStore(BlockPool& pool, std::string pack_path, std::size_t queue_depth)
+    : pool_(pool), pack_path_(std::move(pack_path)), queue_(queue_depth) {
+  if (!pack_path_.empty()) {
+    pack_fd_ = open_out(pack_path_);
+    if (pack_fd_ < 0) pack_error_ = "Cannot open output file: " + pack_path_;
+  }
+  thread_ = std::thread(&TraceStore::run, this);
+}
+
+void TraceStore::submit(std::size_t id, std::string path, ArenaRun run) {
+  queue_.push(Item{id, std::move(path), std::move(run)});
+}
+
+std::map<std::size_t, StoredTrace> TraceStore::finish() {
+  if (thread_.joinable()) {
+    queue_.close();
+    thread_.join();
+  }
+  if (pack_fd_ >= 0) close_out(pack_fd_);
+  pack_fd_ = -1;
+  return stored_;
+}
+
+void TraceStore::run() {
+  std::vector<Item> batch;
+  while (auto item = queue_.pop()) {
+    batch.push_back(std::move(*item));
+    if (!pack_path_.empty()) {
+      while (batch.size() < kMaxBatchRuns) {
+        auto more = queue_.try_pop();
+        if (!more) break;
+        batch.push_back(std::move(*more));
+      }
+      write_pack(batch);
+    } else {
+      write_files(batch);
+    }
+    for (auto& it : batch) pool_.release(it.run.blocks);
+    batch.clear();
+  }
+}
+
+void TraceStore::write_files(std::vector<Item>& batch) {
+  std::vector<Piece> pieces;
+  for (auto& it : batch) {
+    StoredTrace& st = stored_[it.id];
+    st.path = it.path;
+    st.bytes = it.run.bytes;
+    st.rows = it.run.rows;
+
+    const int fd = open_out(it.path);
+    if (fd < 0) {
+      st.error = "Cannot open output file: " + it.path;
+      continue;
+    }
+    pieces.clear();
+    append_pieces(it.run, pieces);
+    if (!write_all(fd, pieces)) st.error = "Write failed: " + it.path;
+    close_out(fd);
+  }
+}
+
+void TraceStore::write_pack(std::vector<Item>& batch) {
+  std::vector<Piece> pieces;
+  for (auto& it : batch) {
+    StoredTrace& st = stored_[it.id];
+    st.path = pack_path_;
+    st.offset = pack_offset_;
+    st.bytes = it.run.bytes;
+    st.rows = it.run.rows;
+    st.error = pack_error_;
+    pack_offset_ += it.run.bytes;
+    append_pieces(it.run, pieces);
+  }
+  if (pack_fd_ < 0 || write_all(pack_fd_, pieces)) return;
+
+  // later offsets would be wrong, so the pack is closed for the rest of the sweep
+  pack_error_ = "Write failed: " + pack_path_;
+  close_out(pack_fd_);
+  pack_fd_ = -1;
+  for (auto& it : batch) stored_[it.id].error = pack_error_;
+}
+
+}  // namespace sim
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include "sim/closed_loop.hpp"
+#include "sim/falsify.hpp"
+
+static sim::LeadCaseParams cut_in_with_dropout() {
+  sim::LeadCaseParams p{};
+  p.ego_speed_mps = 25.0;
+  p.lead_speed_mps = 20.0;
+  p.gap_m = 30.0;
+  p.cut_in_s = 1.0;
+  p.brake_start_s = 3.0;
+  p.brake_decel_mps2 = 4.0;
+  p.dropout_start_s = 6.0;
+  p.dropout_len_s = 0.5;
+  return p;
+}
+
+TEST(Falsify, LeadCaseHasCutInAndDropout) {
+  const auto sc = sim::make_lead_case(cut_in_with_dropout(), 15.0, 0.02);
+
+  EXPECT_FALSE(sc.sample(0.5).lead_valid);
+  const auto at_cut_in = sc.sample(1.0);
+  EXPECT_TRUE(at_cut_in.lead_valid);
+  EXPECT_TRUE(at_cut_in.has_distance_override);
+  EXPECT_DOUBLE_EQ(at_cut_in.lead_distance_m_override, 30.0);
+  EXPECT_FALSE(sc.sample(1.02).has_distance_override);
+
+  EXPECT_FALSE(sc.sample(6.2).lead_valid);
+  EXPECT_TRUE(sc.sample(6.5).lead_valid);
+  EXPECT_NEAR(sc.sample(5.0).v_lead_mps, 12.0, 1e-9);
+  EXPECT_NEAR(sc.sample(10.0).v_lead_mps, 0.0, 1e-9);
+}
+
+TEST(Falsify, SavedScenarioLoadsBack) {
+  const auto sc = sim::make_lead_case(cut_in_with_dropout(), 15.0, 0.02);
+  const std::string path = "falsify_roundtrip.csv";
+  sim::save_csv(path, sc, {{"falsify_score", -1.5}});
+
+  const auto back = sim::load_csv(path);
+  EXPECT_DOUBLE_EQ(back.meta.Ts_s, sc.meta.Ts_s);
+  EXPECT_DOUBLE_EQ(back.meta.init_ego_speed_mps, sc.meta.init_ego_speed_mps);
+  ASSERT_EQ(back.rows.size(), sc.rows.size());
+  for (std::size_t i = 0; i < sc.rows.size(); ++i) {
+    EXPECT_EQ(back.rows[i].t_s, sc.rows[i].t_s);
+    EXPECT_EQ(back.rows[i].lead_valid, sc.rows[i].lead_valid);
+    EXPECT_NEAR(back.rows[i].v_lead_mps, sc.rows[i].v_lead_mps, 1e-9);
+    EXPECT_EQ(back.rows[i].has_distance_override, sc.rows[i].has_distance_override);
+  }
+}
+
+TEST(Falsify, CutInOverrideHoldsForOneLoopTick) {
+  const double Ts = 0.02;
+  sim::LeadCaseParams p = cut_in_with_dropout();
+  for (int k = 2; k < 200; ++k) {
+    p.cut_in_s = k * Ts;
+    const auto sc = sim::make_lead_case(p, 15.0, Ts);
+    EXPECT_TRUE(sc.sample(static_cast<double>(k) * Ts).has_distance_override) << k;
+    EXPECT_FALSE(sc.sample(static_cast<double>(k + 1) * Ts).has_distance_override) << k;
+  }
+}
+
+TEST(Falsify, DropoutKeepsPhysicalGap) {
+  sim::LeadCaseParams p = cut_in_with_dropout();
+  p.cut_in_s = 0.0;
+  p.lead_speed_mps = 25.0;
+  p.brake_start_s = 15.0;
+
+  acc::Config cfg{};
+  sim::RunOptions opt{};
+  const auto sc = sim::make_lead_case(p, 15.0, 0.02);
+  sim::Sample after{};
+  sim::run_closed_loop(sc, cfg, opt, [&](const sim::Sample& s) {
+    if (std::abs(s.in.t_s - 7.0) < 1e-6) after = s;
+  });
+
+  EXPECT_EQ(after.out.mode, acc::Mode::FOLLOW);
+  EXPECT_TRUE(std::isfinite(after.lead_distance_m));
+  EXPECT_GT(after.lead_distance_m, 10.0);
+}
+
+TEST(Falsify, SearchIsDeterministicAndSorted) {
+  acc::Config cfg{};
+  sim::FalsifyOptions opt{};
+  opt.iterations = 3;
+  opt.population = 16;
+  opt.keep = 3;
+
+  opt.workers = 1;
+  const auto a = sim::falsify(cfg, opt);
+  opt.workers = 3;
+  const auto b = sim::falsify(cfg, opt);
+
+  ASSERT_FALSE(a.empty());
+  ASSERT_EQ(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    EXPECT_DOUBLE_EQ(a[i].score, b[i].score);
+    EXPECT_TRUE(a[i].feasible);
+    if (i > 0) {
+      EXPECT_LE(a[i - 1].score, a[i].score);
+    }
+  }
+}
+
+TEST(Falsify, FalseAebKeepsOnlyActivations) {
+  acc::Config cfg{};
+  sim::FalsifyOptions opt{};
+  opt.objective = sim::FalsifyObjective::FALSE_AEB;
+  opt.iterations = 5;
+  opt.population = 32;
+  opt.seed = 7;
+
+  const auto worst = sim::falsify(cfg, opt);
+  ASSERT_FALSE(worst.empty());
+  for (const auto& c : worst) {
+    EXPECT_GT(c.aeb_time_s, 0.0);
+    EXPECT_LT(c.score, 0.0);
+  }
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+#include "sim/closed_loop.hpp"
+#include "sim/kpi.hpp"
+#include "sim/scenario.hpp"
+
+static sim::Scenario long_cruise(double duration_s, double v_set_step_at_s) {
+  sim::Scenario sc{};
+  sc.meta.Ts_s = 0.02;
+  sc.meta.init_ego_speed_mps = 20.0;
+  sc.meta.init_lead_distance_m = 100.0;
+
+  // hidden lead: the gap opens at v_set=25 and closes (down to 0) at v_set=30
+  sim::Row r{};
+  r.lead_valid = false;
+  r.v_lead_mps = 27.0;
+  r.v_set_mps = 25.0;
+  r.t_s = 0.0;
+  sc.rows.push_back(r);
+  r.t_s = v_set_step_at_s;
+  sc.rows.push_back(r);
+  r.v_set_mps = 30.0;
+  r.t_s = v_set_step_at_s + 1.0;
+  sc.rows.push_back(r);
+  r.t_s = duration_s;
+  sc.rows.push_back(r);
+  return sc;
+}
+
+static std::map<long, sim::Sample> run_by_tick(const sim::Scenario& sc, bool fast_forward,
+                                               sim::RunStats* stats) {
+  acc::Config cfg{};
+  cfg.Ts_s = sc.meta.Ts_s;
+  sim::RunOptions opt{};
+  opt.fast_forward = fast_forward;
+
+  std::map<long, sim::Sample> out;
+  *stats = sim::run_closed_loop(sc, cfg, opt, [&](const sim::Sample& s) {
+    out[std::lround(s.in.t_s / cfg.Ts_s)] = s;
+  });
+  return out;
+}
+
+TEST(ScenarioSteady, SteadyUntilStopsAtInputChange) {
+  const auto sc = long_cruise(100.0, 40.0);
+  EXPECT_DOUBLE_EQ(sc.steady_until(0.0), 40.0);
+  EXPECT_DOUBLE_EQ(sc.steady_until(39.0), 40.0);
+  EXPECT_DOUBLE_EQ(sc.steady_until(40.5), 40.5);  // v_set ramp
+  EXPECT_TRUE(std::isinf(sc.steady_until(41.0)));
+}
+
+static sim::Kpis kpis_of(const sim::Scenario& sc, const std::map<long, sim::Sample>& rows) {
+  acc::Config cfg{};
+  cfg.Ts_s = sc.meta.Ts_s;
+  sim::KpiAccumulator acc(cfg, rows.rbegin()->second.in.t_s);
+  for (const auto& [k, s] : rows) acc.add(s);
+  return acc.result();
+}
+
+TEST(FastForward, HourLongCruiseMatchesExactRun) {
+  const auto sc = long_cruise(3600.0, 1800.0);
+
+  sim::RunStats exact_stats{};
+  sim::RunStats ff_stats{};
+  const auto exact = run_by_tick(sc, false, &exact_stats);
+  const auto ff = run_by_tick(sc, true, &ff_stats);
+
+  EXPECT_EQ(exact_stats.ticks, ff_stats.ticks);
+  EXPECT_EQ(exact_stats.steps, exact_stats.ticks);
+  EXPECT_EQ(exact_stats.samples, exact_stats.ticks);
+  EXPECT_LT(ff_stats.steps * 20, exact_stats.steps);
+  EXPECT_LT(ff_stats.samples * 20, exact_stats.samples);
+  EXPECT_EQ(ff.size(), ff_stats.samples);
+
+  // every row (summary rows included) carries the exact state of its tick
+  std::size_t covered = 0;
+  for (const auto& [k, s] : ff) {
+    const auto& e = exact.at(k);
+    covered += s.ticks;
+    EXPECT_EQ(s.in.t_s, e.in.t_s) << "tick " << k;
+    EXPECT_EQ(s.in.ego_speed_mps, e.in.ego_speed_mps) << "tick " << k;
+    EXPECT_EQ(s.ego_speed_mps, e.ego_speed_mps) << "tick " << k;
+    EXPECT_EQ(s.out.a_cmd_mps2, e.out.a_cmd_mps2) << "tick " << k;
+    EXPECT_EQ(s.out.a_cruise_mps2, e.out.a_cruise_mps2) << "tick " << k;
+    EXPECT_EQ(s.lead_gap_m, e.lead_gap_m) << "tick " << k;
+    EXPECT_EQ(s.out.mode, e.out.mode) << "tick " << k;
+  }
+  EXPECT_EQ(covered, ff_stats.ticks);
+
+  // the last 5 s are stepped exactly; inside a stretch the jerk stays below half the limit
+  const auto ke = kpis_of(sc, exact);
+  const auto kf = kpis_of(sc, ff);
+  EXPECT_EQ(kf.cruise_ss_speed_err_mps, ke.cruise_ss_speed_err_mps);
+  EXPECT_LE(kf.max_jerk_comfort_mps3, ke.max_jerk_comfort_mps3);
+  EXPECT_GE(kf.max_jerk_comfort_mps3, ke.max_jerk_comfort_mps3 - 0.5 * acc::Config{}.jerk_max_mps3);
+  EXPECT_EQ(kf.aeb_time_s, ke.aeb_time_s);
+  EXPECT_NEAR(ff.rbegin()->second.ego_speed_mps, 30.0, 0.05);
+}
+
+TEST(FastForward, NoSkippingWithLead) {
+  sim::Scenario sc{};
+  sc.meta.init_ego_speed_mps = 25.0;
+  sc.meta.init_lead_distance_m = 40.0;
+  sim::Row r{};
+  r.lead_valid = true;
+  r.v_lead_mps = 25.0;
+  r.t_s = 0.0;
+  sc.rows.push_back(r);
+  r.t_s = 20.0;
+  sc.rows.push_back(r);
+
+  sim::RunStats stats{};
+  run_by_tick(sc, true, &stats);
+  EXPECT_EQ(stats.steps, stats.ticks);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "acc/function.hpp"
+#include "acc/metrics.hpp"
+#include "sim/metrics_exporter.hpp"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static acc::Input closing_lead(double distance_m) {
+  acc::Input in{};
+  in.acc_enable = true;
+  in.ego_speed_mps = 20.0;
+  in.lead_valid = true;
+  in.lead_distance_m = distance_m;
+  in.lead_rel_speed_mps = -10.0;
+  return in;
+}
+
+TEST(Metrics, CountsModesAebActivationsAndTtc) {
+  acc::Metrics m(1);
+  acc::Function fn(acc::Config{});
+  fn.attach_metrics(&m);
+
+  fn.step(closing_lead(40.0));  // FOLLOW, TTC 4 s
+  fn.step(closing_lead(10.0));  // AEB, TTC 1 s
+  fn.step(closing_lead(10.0));  // still AEB
+  acc::Input off{};
+  fn.step(off);  // OFF
+
+  const auto s = m.snapshot();
+  EXPECT_EQ(s.steps, 4U);
+  EXPECT_EQ(s.mode_ticks[static_cast<int>(acc::Mode::FOLLOW)], 1U);
+  EXPECT_EQ(s.mode_ticks[static_cast<int>(acc::Mode::AEB)], 2U);
+  EXPECT_EQ(s.mode_ticks[static_cast<int>(acc::Mode::OFF)], 1U);
+  EXPECT_EQ(s.aeb_activations, 1U);
+  EXPECT_NEAR(s.ttc_min_s, 1.0, 1e-9);
+  EXPECT_EQ(s.latency_count, 4U);
+}
+
+TEST(Metrics, ShardsSumAcrossThreads) {
+  acc::Metrics m;
+  constexpr int kThreads = 8;
+  constexpr int kSteps = 20000;
+
+  std::vector<std::thread> pool;
+  for (int t = 0; t < kThreads; ++t) {
+    pool.emplace_back([&] {
+      acc::Function fn(acc::Config{});
+      fn.attach_metrics(&m);
+      for (int i = 0; i < kSteps; ++i) fn.step(closing_lead(40.0));
+    });
+  }
+  for (auto& th : pool) th.join();
+
+  const auto s = m.snapshot();
+  EXPECT_EQ(s.steps, static_cast<std::uint64_t>(kThreads) * kSteps);
+  EXPECT_EQ(s.mode_ticks[static_cast<int>(acc::Mode::FOLLOW)], s.steps);
+  EXPECT_GE(s.latency_count, static_cast<std::uint64_t>(kThreads) * kSteps / 64);
+}
+
+TEST(Metrics, ExitedThreadsReturnTheirShards) {
+  acc::Metrics a;
+  acc::Metrics b;
+  for (int t = 0; t < 3 * static_cast<int>(acc::Metrics::kShards); ++t) {
+    std::thread([&] {
+      for (int i = 0; i < 10; ++i) {  // alternating registries keeps one claim on each
+        a.record_ticks(acc::Mode::CRUISE, 1);
+        b.record_ticks(acc::Mode::CRUISE, 1);
+      }
+      EXPECT_EQ(a.exclusive_writers(), 1U);
+      EXPECT_EQ(b.exclusive_writers(), 1U);
+    }).join();
+  }
+  EXPECT_EQ(a.exclusive_writers(), 0U);
+  EXPECT_EQ(a.snapshot().mode_ticks[static_cast<int>(acc::Mode::CRUISE)],
+            30U * acc::Metrics::kShards);
+}
+
+TEST(Metrics, ExporterFlagsMustParse) {
+  acc::Metrics m;
+  sim::MetricsExporter ex(m);
+  EXPECT_THROW(sim::start_exporter(ex, "", "abc", "1000"), std::invalid_argument);
+  EXPECT_THROW(sim::start_exporter(ex, "", "80x", "1000"), std::invalid_argument);
+  EXPECT_THROW(sim::start_exporter(ex, "m.prom", "-1", "0"), std::invalid_argument);
+  EXPECT_FALSE(sim::start_exporter(ex, "", "-1", "1000"));
+}
+
+TEST(Metrics, PrometheusTextAndFileSnapshot) {
+  acc::Metrics m;
+  acc::Function fn(acc::Config{});
+  fn.attach_metrics(&m);
+  fn.step(closing_lead(40.0));
+
+  const std::string text = sim::to_prometheus(m.snapshot());
+  EXPECT_NE(text.find("acc_steps_total 1\n"), std::string::npos);
+  EXPECT_NE(text.find("acc_mode_ticks_total{mode=\"FOLLOW\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("acc_step_latency_seconds_bucket{le=\"+Inf\"} 1\n"), std::string::npos);
+
+  const std::string path = "metrics_snapshot.prom";
+  sim::MetricsExporter ex(m);
+  sim::ExporterOptions opt{};
+  opt.file_path = path;
+  opt.period = std::chrono::milliseconds(10);
+  ASSERT_TRUE(ex.start(opt));
+  fn.step(closing_lead(40.0));
+  ex.stop();
+
+  std::ifstream f(path);
+  std::stringstream ss;
+  ss << f.rdbuf();
+  EXPECT_NE(ss.str().find("acc_steps_total 2\n"), std::string::npos);
+}
+
+#ifndef _WIN32
+TEST(Metrics, ServesHttpOnLocalhost) {
+  acc::Metrics m;
+  sim::MetricsExporter ex(m);
+  sim::ExporterOptions opt{};
+  opt.http_port = 0;
+  ASSERT_TRUE(ex.start(opt));
+
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<std::uint16_t>(ex.http_port()));
+  ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+  const std::string req = "GET /metrics HTTP/1.0\r\n\r\n";
+  ASSERT_EQ(::send(fd, req.data(), req.size(), 0), static_cast<ssize_t>(req.size()));
+  std::string resp;
+  char buf[4096];
+  for (ssize_t n; (n = ::recv(fd, buf, sizeof(buf), 0)) > 0;) resp.append(buf, n);
+  ::close(fd);
+
+  EXPECT_EQ(resp.rfind("HTTP/1.0 200 OK", 0), 0U);
+  EXPECT_NE(resp.find("acc_steps_total 0\n"), std::string::npos);
+}
+#endif
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "sim/closed_loop.hpp"
+#include "sim/multirate.hpp"
+#include "sim/scenario.hpp"
+
+static sim::Scenario lead_brake() {
+  sim::Scenario sc{};
+  sc.meta.Ts_s = 0.02;
+  sc.meta.init_ego_speed_mps = 25.0;
+  sc.meta.init_lead_distance_m = 45.0;
+  const double rows[][2] = {{0.0, 25.0}, {2.0, 25.0}, {3.0, 10.0}, {6.0, 10.0}, {8.0, 0.0},
+                            {10.0, 0.0}};
+  for (const auto& r : rows) {
+    sim::Row row{};
+    row.t_s = r[0];
+    row.lead_valid = true;
+    row.v_lead_mps = r[1];
+    sc.rows.push_back(row);
+  }
+  return sc;
+}
+
+TEST(MultiRate, SingleRateMatchesClosedLoop) {
+  const auto sc = lead_brake();
+  acc::Config cfg{};
+
+  std::vector<sim::Sample> ref;
+  sim::run_closed_loop(sc, cfg, sim::RunOptions{},
+                       [&](const sim::Sample& s) { ref.push_back(s); });
+
+  sim::MultiRateOptions opt{};
+  opt.plant_dt_s = opt.controller_dt_s = opt.sensor_dt_s = 0.02;
+  std::vector<sim::Sample> mr;
+  const auto stats =
+      sim::run_multirate(sc, cfg, opt, [&](const sim::Sample& s) { mr.push_back(s); });
+
+  ASSERT_EQ(mr.size(), ref.size());
+  EXPECT_EQ(stats.plant_steps, ref.size());
+  for (std::size_t i = 0; i < ref.size(); ++i) {
+    EXPECT_NEAR(mr[i].in.t_s, ref[i].in.t_s, 1e-12) << i;
+    EXPECT_NEAR(mr[i].in.lead_distance_m, ref[i].in.lead_distance_m, 1e-9) << i;
+    EXPECT_NEAR(mr[i].ego_speed_mps, ref[i].ego_speed_mps, 1e-9) << i;
+    EXPECT_NEAR(mr[i].lead_distance_m, ref[i].lead_distance_m, 1e-9) << i;
+    EXPECT_NEAR(mr[i].lead_gap_m, ref[i].lead_gap_m, 1e-9) << i;
+    EXPECT_NEAR(mr[i].in.ego_speed_mps, ref[i].in.ego_speed_mps, 1e-9) << i;
+    EXPECT_NEAR(mr[i].out.a_cmd_mps2, ref[i].out.a_cmd_mps2, 1e-9) << i;
+    EXPECT_EQ(mr[i].out.mode, ref[i].out.mode) << i;
+  }
+}
+
+TEST(MultiRate, SensorSampleAndHoldWithLatency) {
+  auto sc = lead_brake();
+  sc.meta.init_ego_speed_mps = 30.0;  // closing from the start, so every measurement differs
+
+  sim::MultiRateOptions opt{};
+  opt.plant_dt_s = 0.001;
+  opt.controller_dt_s = 0.02;
+  opt.sensor_dt_s = 0.1;
+  opt.sensor_latency_s = 0.05;
+
+  std::vector<sim::Sample> out;
+  const auto stats =
+      sim::run_multirate(sc, acc::Config{}, opt, [&](const sim::Sample& s) { out.push_back(s); });
+
+  EXPECT_EQ(stats.controller_steps, 501U);
+  EXPECT_EQ(stats.plant_steps, 10020U);  // up to the tick after the last controller step
+  EXPECT_EQ(stats.sensor_samples, 101U);
+
+  // nothing delivered before the first latency has elapsed
+  EXPECT_FALSE(out[0].in.lead_valid);
+  EXPECT_FALSE(out[2].in.lead_valid);
+  EXPECT_TRUE(out[3].in.lead_valid);  // t = 0.06 s
+
+  // held for 5 controller ticks, then the next measurement arrives
+  for (std::size_t i = 4; i < 8; ++i) {
+    EXPECT_EQ(out[i].in.lead_distance_m, out[3].in.lead_distance_m) << i;
+  }
+  EXPECT_NE(out[8].in.lead_distance_m, out[3].in.lead_distance_m);
+
+  // rows log the sensor view after the step (what the next step sees); t_s stays on the grid
+  EXPECT_TRUE(std::isinf(out[0].lead_distance_m));
+  EXPECT_GT(out[0].lead_gap_m, 0.0);
+  for (std::size_t i = 0; i + 1 < out.size(); ++i) {
+    EXPECT_EQ(out[i].lead_distance_m, out[i + 1].in.lead_distance_m) << i;
+  }
+  EXPECT_EQ(out[5].in.t_s, 0.1);
+}
+
+TEST(MultiRate, DistanceOverrideAppliesOnce) {
+  auto sc = lead_brake();
+  sc.rows[1].has_distance_override = true;  // in effect from 2 s to 3 s
+  sc.rows[1].lead_distance_m_override = 30.0;
+
+  sim::MultiRateOptions opt{};
+  opt.plant_dt_s = 0.001;
+  opt.sensor_dt_s = 0.02;
+  std::vector<sim::Sample> out;
+  sim::run_multirate(sc, acc::Config{}, opt, [&](const sim::Sample& s) { out.push_back(s); });
+
+  // reset to 30 m at 2 s, then the gap evolves again instead of staying frozen
+  EXPECT_NEAR(out[100].in.lead_distance_m, 30.0, 1e-9);
+  EXPECT_GT(std::abs(out[140].in.lead_distance_m - 30.0), 0.1);
+}
+
+TEST(MultiRate, RejectsZeroPeriod) {
+  sim::MultiRateOptions opt{};
+  opt.sensor_dt_s = 0.0;
+  EXPECT_THROW(sim::run_multirate(lead_brake(), acc::Config{}, opt, [](const sim::Sample&) {}),
+               std::invalid_argument);
+}
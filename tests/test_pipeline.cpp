@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "sim/bounded_queue.hpp"
+#include "sim/campaign.hpp"
+#include "sim/scenario.hpp"
+#include "sim/trace_csv.hpp"
+#include "sim/trace_store.hpp"
+
+static double kpi_value(const std::string& kpi_file, const std::string& key) {
+  std::ifstream f(kpi_file);
+  if (!f) throw std::runtime_error("Cannot open KPI file: " + kpi_file);
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.rfind(key, 0) == 0) return std::stod(line.substr(line.find(':') + 1));
+  }
+  throw std::runtime_error("Key not found in KPI file: " + key);
+}
+
+TEST(BoundedQueue, DeliversInOrderAndDrainsAfterClose) {
+  sim::BoundedQueue<int> q(2);
+  std::thread producer([&] {
+    for (int i = 0; i < 100; ++i) q.push(i);
+    q.close();
+  });
+
+  std::vector<int> got;
+  while (auto v = q.pop()) got.push_back(*v);
+  producer.join();
+
+  ASSERT_EQ(got.size(), 100U);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(got[i], i);
+  EXPECT_FALSE(q.push(1));
+}
+
+// C++ KPIs (report file) against tools/evaluate_kpis.py on the written trace.
+static void expect_kpis_match_python(const sim::CampaignResult& r) {
+  const std::string py_report = r.trace_path + ".py_kpi.txt";
+  ASSERT_EQ(std::system(("python3 ../tools/evaluate_kpis.py " + r.trace_path +
+                         " 0.02 3.0 1.5 3.0 > " + py_report).c_str()),
+            0);
+
+  for (const char* key : {"min_distance_m", "min_ttc_s", "aeb_time_s", "max_jerk_comfort_mps3",
+                          "max_jerk_emergency_mps3", "cruise_ss_speed_err_mps",
+                          "follow_ss_tgap_err_s"}) {
+    const double py = kpi_value(py_report, key);
+    const double cc = kpi_value(r.report_path, key);
+    if (std::isnan(py)) {
+      EXPECT_TRUE(std::isnan(cc)) << r.scenario_path << " " << key;
+    } else if (std::isinf(py)) {
+      EXPECT_EQ(cc, py) << r.scenario_path << " " << key;
+    } else {
+      EXPECT_NEAR(cc, py, 2e-3) << r.scenario_path << " " << key;
+    }
+  }
+}
+
+TEST(Campaign, KpisMatchPythonEvaluator) {
+  const std::vector<std::string> paths = {
+      "../scenarios/cruise_step.csv", "../scenarios/follow_constant_lead.csv",
+      "../scenarios/lead_brake.csv", "../scenarios/missing.csv"};
+  sim::CampaignOptions opt{};
+  opt.out_dir = "../results/ci_campaign";
+  opt.kpi_reports = true;
+  opt.sim_workers = 2;
+  opt.queue_depth = 2;
+  opt.chunk_samples = 64;  // several batches per run
+
+  const auto results = sim::run_campaign(paths, opt);
+  ASSERT_EQ(results.size(), paths.size());
+  EXPECT_FALSE(results[3].error.empty());
+
+  for (std::size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(results[i].error.empty()) << results[i].error;
+    expect_kpis_match_python(results[i]);
+  }
+}
+
+TEST(Campaign, FastForwardSummaryRowsMatchPythonEvaluator) {
+  // 10 min of cruise without a lead and a set-speed step halfway: mostly summary rows
+  sim::Scenario sc{};
+  sc.meta.Ts_s = 0.02;
+  sc.meta.init_ego_speed_mps = 20.0;
+  sc.meta.init_lead_distance_m = 100.0;
+  const std::pair<double, double> set_points[] = {{0.0, 25.0}, {300.0, 25.0}, {301.0, 30.0},
+                                                  {600.0, 30.0}};
+  for (const auto& [t, v_set] : set_points) {
+    sim::Row r{};
+    r.t_s = t;
+    r.lead_valid = false;
+    r.v_set_mps = v_set;
+    sc.rows.push_back(r);
+  }
+  const std::string path = "../results/ci_long_cruise.csv";
+  sim::save_csv(path, sc);
+
+  sim::CampaignOptions opt{};
+  opt.out_dir = "../results/ci_campaign_ff";
+  opt.kpi_reports = true;
+  opt.run.fast_forward = true;
+  const auto results = sim::run_campaign({path}, opt);
+  ASSERT_EQ(results.size(), 1U);
+  ASSERT_TRUE(results[0].error.empty()) << results[0].error;
+  EXPECT_LT(results[0].trace_bytes, 1000U * 100U);  // 30001 ticks, far fewer rows
+  expect_kpis_match_python(results[0]);
+}
+
+static std::string read_bytes(const std::string& path, std::uint64_t offset, std::uint64_t n) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) throw std::runtime_error("Cannot open file: " + path);
+  f.seekg(static_cast<std::streamoff>(offset));
+  std::string s(n, '\0');
+  f.read(s.data(), static_cast<std::streamsize>(n));
+  return s;
+}
+
+TEST(TraceStore, ArenaBlocksReassembleRowsAcrossBoundaries) {
+  sim::BlockPool pool(7);  // rows straddle blocks
+  sim::TraceStore store(pool, "", 2);
+  sim::TraceArena arena(pool);
+
+  sim::Sample s{};
+  s.in.t_s = 0.02;
+  s.ego_speed_mps = 25.5;
+  arena.begin_run();
+  arena.add(s);
+  arena.add(s);
+  auto run = arena.take();
+  EXPECT_EQ(run.rows, 2U);
+  EXPECT_GT(run.blocks.size(), 2U);
+
+  std::ostringstream expect;
+  sim::write_trace_header(expect);
+  sim::write_trace_row(expect, s);
+  sim::write_trace_row(expect, s);
+  EXPECT_EQ(run.bytes, expect.str().size());
+
+  const std::size_t bytes = run.bytes;
+  store.submit(0, "../results/ci_arena_trace.csv", std::move(run));
+  const auto stored = store.finish();
+  ASSERT_EQ(stored.size(), 1U);
+  EXPECT_TRUE(stored.at(0).error.empty()) << stored.at(0).error;
+  EXPECT_EQ(read_bytes("../results/ci_arena_trace.csv", 0, bytes), expect.str());
+}
+
+TEST(Campaign, PackedSweepMatchesPerRunFiles) {
+  const std::vector<std::string> paths = {"../scenarios/follow_constant_lead.csv",
+                                          "../scenarios/lead_brake.csv"};
+  sim::CampaignOptions opt{};
+  opt.configs.resize(2);
+  opt.configs[1].time_gap_s = 2.0;
+  opt.sim_workers = 2;
+  opt.arena_block_bytes = 4096;
+
+  opt.out_dir = "../results/ci_campaign_sweep";
+  const auto files = sim::run_campaign(paths, opt);
+  opt.out_dir = "../results/ci_campaign_pack";
+  opt.pack_traces = true;
+  const auto packed = sim::run_campaign(paths, opt);
+
+  ASSERT_EQ(files.size(), 4U);
+  ASSERT_EQ(packed.size(), 4U);
+  EXPECT_NE(files[0].config_hash, files[1].config_hash);
+  EXPECT_EQ(files[0].config_hash, files[2].config_hash);
+
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    ASSERT_TRUE(files[i].error.empty()) << files[i].error;
+    ASSERT_TRUE(packed[i].error.empty()) << packed[i].error;
+    EXPECT_EQ(files[i].config_hash, packed[i].config_hash);
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx",
+                  static_cast<unsigned long long>(files[i].config_hash));
+    EXPECT_NE(files[i].trace_path.find(hex), std::string::npos) << files[i].trace_path;
+    EXPECT_NE(files[i].report_path.find("index.csv"), std::string::npos);  // no per-run report
+    EXPECT_EQ(packed[i].trace_bytes, files[i].trace_bytes);
+    EXPECT_EQ(read_bytes(packed[i].trace_path, packed[i].trace_offset, packed[i].trace_bytes),
+              read_bytes(files[i].trace_path, 0, files[i].trace_bytes));
+    EXPECT_EQ(packed[i].kpis.min_distance_m, files[i].kpis.min_distance_m);
+  }
+  // the larger time gap keeps more distance behind the braking lead
+  EXPECT_GT(files[3].kpis.min_distance_m, files[2].kpis.min_distance_m);
+
+  std::ifstream index("../results/ci_campaign_pack/index.csv");
+  std::size_t lines = 0;
+  for (std::string line; std::getline(index, line);) ++lines;
+  EXPECT_EQ(lines, 1U + packed.size());
+}
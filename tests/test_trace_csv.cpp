@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "sim/parse_number.hpp"
+#include "sim/trace_csv.hpp"
+
+static sim::Sample make_sample(double k) {
+  sim::Sample s{};
+  s.in.t_s = 0.02 * k;
+  s.in.v_set_mps = 30.0;
+  s.in.lead_valid = true;
+  s.in.lead_rel_speed_mps = -5.0 + 0.0008 * k;
+  s.out.mode = acc::Mode::FOLLOW;
+  s.out.a_cmd_mps2 = -0.04 * k;
+  s.out.ttc_s = (k > 2.0) ? std::numeric_limits<double>::infinity() : 5.98096015362458;
+  s.out.d_des_m = 40.4988 - 1e-7 * k;
+  s.out.distance_error_m = -10.598783999999995;
+  s.out.a_cruise_mps2 = 3.000480000000001e-5;
+  s.out.a_follow_mps2 = -9.1786752e12;
+  s.ego_speed_mps = 24.9976 / 3.0;
+  s.lead_distance_m = 29.800064000000003;
+  return s;
+}
+
+static std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> out;
+  std::stringstream ss(line);
+  for (std::string f; std::getline(ss, f, ',');) out.push_back(f);
+  return out;
+}
+
+TEST(TraceCsv, DefaultPrecisionMatchesOstreamDefault) {
+  const sim::TraceFormatter fmt;
+  ASSERT_EQ(fmt.format().precision, 6);
+  std::vector<char> buf(fmt.max_row_bytes());
+  for (double k = 0.0; k < 5.0; k += 1.0) {
+    const sim::Sample s = make_sample(k);
+    std::ostringstream os;
+    os << s.in.t_s << "," << static_cast<int>(s.out.mode) << "," << s.ego_speed_mps << ","
+       << s.in.v_set_mps << "," << (s.in.lead_valid ? 1 : 0) << "," << s.lead_distance_m << ","
+       << s.in.lead_rel_speed_mps << "," << s.out.a_cmd_mps2 << "," << s.out.ttc_s << ","
+       << s.out.d_des_m << "," << s.out.distance_error_m << "," << s.out.a_cruise_mps2 << ","
+       << s.out.a_follow_mps2 << "\n";
+    EXPECT_EQ(std::string(buf.data(), fmt.row(buf.data(), s)), os.str());
+  }
+}
+
+TEST(TraceCsv, ShortestFormatRoundTrips) {
+  const sim::TraceFormatter fmt(sim::TraceFormat{{}, 0, 1});
+  std::vector<char> buf(fmt.max_row_bytes());
+  const sim::Sample s = make_sample(3.0);
+  const auto fields = split(std::string(buf.data(), fmt.row(buf.data(), s) - 1));
+  ASSERT_EQ(fields.size(), sim::kNumDefaultTraceColumns);
+
+  EXPECT_EQ(std::strtod(fields[0].c_str(), nullptr), s.in.t_s);
+  EXPECT_EQ(fields[1], "2");
+  EXPECT_EQ(std::strtod(fields[2].c_str(), nullptr), s.ego_speed_mps);
+  EXPECT_EQ(fields[4], "1");
+  EXPECT_EQ(fields[8], "inf");
+  EXPECT_EQ(std::strtod(fields[9].c_str(), nullptr), s.out.d_des_m);
+  EXPECT_EQ(std::strtod(fields[11].c_str(), nullptr), s.out.a_cruise_mps2);
+  EXPECT_EQ(std::strtod(fields[12].c_str(), nullptr), s.out.a_follow_mps2);
+}
+
+TEST(TraceCsv, WriterSelectsColumnsAndDecimates) {
+  std::ostringstream os;
+  {
+    sim::TraceFormat f;
+    f.columns = sim::parse_trace_columns("a_cmd_mps2,t_s");
+    f.every_n = 3;
+    sim::TraceWriter w(os, f, 64);  // small buffer: several flushes
+    for (int k = 0; k < 10; ++k) w.add(make_sample(k));
+  }
+
+  std::stringstream in(os.str());
+  std::vector<std::string> lines;
+  for (std::string l; std::getline(in, l);) lines.push_back(l);
+  ASSERT_EQ(lines.size(), 5U);  // header + samples 0, 3, 6, 9
+  EXPECT_EQ(lines[0], "a_cmd_mps2,t_s");
+  EXPECT_EQ(lines[2], "-0.12,0.06");
+  EXPECT_EQ(std::strtod(split(lines[4])[1].c_str(), nullptr), 0.02 * 9.0);
+}
+
+TEST(TraceCsv, RejectsUnknownColumn) {
+  EXPECT_THROW(sim::parse_trace_columns("t_s,speed"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_trace_columns(""), std::invalid_argument);
+}
+
+TEST(TraceCsv, ParsesRunnerFlags) {
+  const auto cols = sim::parse_trace_columns(" t_s, mode ,a_cmd_mps2\t");
+  ASSERT_EQ(cols.size(), 3U);
+  EXPECT_EQ(cols[1], sim::TraceColumn::MODE);
+
+  const auto fmt = sim::parse_trace_format("t_s, mode", "6", "10");
+  EXPECT_EQ(fmt.columns.size(), 2U);
+  EXPECT_EQ(fmt.precision, 6);
+  EXPECT_EQ(fmt.every_n, 10U);
+  EXPECT_TRUE(sim::parse_trace_format("", "0", "1").columns.empty());
+  EXPECT_EQ(sim::parse_trace_format("", "0", "1").precision, 0);
+
+  EXPECT_THROW(sim::parse_trace_format("", "6x", "1"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_trace_format("", "0", "0"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_trace_format("", "-1", "1"), std::invalid_argument);
+}
+
+TEST(TraceCsv, ParseNumberNeedsWholeValueInRange) {
+  EXPECT_EQ(sim::parse_number<int>("--n", "-3"), -3);
+  EXPECT_EQ(sim::parse_number<std::size_t>("--n", "20", 1), 20U);
+  EXPECT_DOUBLE_EQ(sim::parse_number("--x", "1.5", 0.0), 1.5);
+
+  EXPECT_THROW(sim::parse_number<std::size_t>("--n", "20x"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number<std::size_t>("--n", "-1"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number<std::size_t>("--n", "0", 1), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number<int>("--n", " 4"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number<int>("--n", ""), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number<int>("--n", "99999999999"), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number("--x", "nan", 0.0), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number("--x", "inf", 0.0), std::invalid_argument);
+  EXPECT_THROW(sim::parse_number("--x", "-0.5", 0.0), std::invalid_argument);
+}
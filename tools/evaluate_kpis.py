@@ -9,7 +9,7 @@ def read_rows(path: str):
         for row in r:
             out = {}
             for k, v in row.items():
-                if k in ("mode", "lead_valid"):
+                if k in ("mode", "lead_valid", "ticks"):
                     out[k] = int(float(v))
                 else:
                     out[k] = float(v)
@@ -55,6 +55,7 @@ def main(path: str, Ts: float = 0.02, ttc_warn: float = 3.0, T_gap: float = 1.5,
         a = row["a_cmd_mps2"]
         v = row["ego_speed_mps"]
         v_set = row.get("v_set_mps", float("nan"))
+        n = row.get("ticks", 1)  # > 1 on fast-forward summary rows
 
         min_a = min(min_a, a)
         max_a = max(max_a, a)
@@ -64,12 +65,12 @@ def main(path: str, Ts: float = 0.02, ttc_warn: float = 3.0, T_gap: float = 1.5,
         if math.isfinite(ttc):
             min_ttc = min(min_ttc, ttc)
         if mode == 3:
-            aeb_time += Ts
+            aeb_time += Ts * n
 
-        # Jerk (exclude AEB and boundary)
+        # Jerk (exclude AEB and boundary); a summary row gives the mean over its ticks
         if prev_a is not None and mode != 3 and prev_mode != 3:
-            jerk = abs(a - prev_a) / Ts
-            jerk_samples += 1
+            jerk = abs(a - prev_a) / (Ts * n)
+            jerk_samples += n
             max_jerk_total = max(max_jerk_total, jerk)
             if math.isfinite(ttc) and ttc < ttc_warn:
                 max_jerk_emergency = max(max_jerk_emergency, jerk)
@@ -78,13 +79,13 @@ def main(path: str, Ts: float = 0.02, ttc_warn: float = 3.0, T_gap: float = 1.5,
 
         # Steady-state speed error for CRUISE (last 2 seconds)
         if mode == 1 and t >= (t_end - 2.0) and math.isfinite(v_set):
-            cruise_speed_err.append(abs(v_set - v))
+            cruise_speed_err += [abs(v_set - v)] * n
 
         # Steady-state time-gap error for FOLLOW (last 5 seconds)
         # actual time gap approx: (d - d0) / v  (if v>0)
         if mode == 2 and lead_valid == 1 and t >= (t_end - 5.0) and v > 0.5 and math.isfinite(d):
             t_gap_actual = (d - d0) / v
-            follow_tgap_err.append(abs(t_gap_actual - T_gap))
+            follow_tgap_err += [abs(t_gap_actual - T_gap)] * n
 
         prev_a = a
         prev_mode = mode